@@ -0,0 +1,209 @@
+#ifndef ANALYZE_H
+#define ANALYZE_H
+
+#include "vm.h"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+/*
+Statik imaj analizi (lc3-analyze). İmaj çalıştırılmadan:
+
+  1. Giriş noktalarından (varsayılan PC_START) recursive descent ile komutlar
+     çözülür. BR hedefleri ve fallthrough'lar takip edilir. JSR hedefleri yeni
+     fonksiyon girişidir, RET (JMP R7) fonksiyondan döner, HALT ve geçersiz
+     opcode akışı bitirir. JSR'den sonraki kelime ancak çağrılan fonksiyonun
+     bir RET'e ulaştığı görülünce kod sayılır (goto olarak kullanılan JSR'ler).
+  2. Temel bloklar ve fonksiyon başına CFG ile çağrı grafiği çıkarılır.
+  3. Yazmaçlar için sabit/işaretçi yayılımı yapılır (dataflow). LEA ve LD sabit
+     verir. LD imajdaki değeri okur; o kelimeye bir store yazabiliyorsa (ya da
+     hedefi bilinmeyen bir store varsa) değer bilinmiyor. Adres
+     olan bir sabite (LEA ya da yüklenmiş bir adresi tutan LD) eklenen bilinmeyen
+     bir değer, o adresin bulunduğu bölgede kalan bir işaretçi sayılır (dizi
+     gezme). Düz bir sayıya eklenen bilinmeyen değer bilinmiyor.
+     Her fonksiyon için yazmaç özeti çıkarılır: giriş değerine sabit eklenmesi
+     (R6 yığın işaretçisi), bilinmeyen eklenmesi, LD/LEA ile atanan değer ya da
+     bozulma. Çağrılan fonksiyona çağrı noktasındaki durum geçer, dönüşte özet
+     uygulanır. Böylece bazı JMP/JSRR hedefleri de çözülür.
+  4. Yüklenmiş ama kod olmayan kelimeler: kod dışı bir bölgede ilk referans
+     verilen (LD/ST/LEA/...) adresten bölge sonuna kadar veri, öncesi erişilemez.
+  5. Her store için koda yazıp yazamayacağı belirlenir. Kendini değiştiren kod
+     yoksa imaj hızlı yollarda (lockstep ensemble, paylaşılan sayfalar) fallback'e
+     düşmeden çalışır. Çözülemeyen JMP/JSRR ya da yüklenmemiş belleğe düşen akış
+     varsa keşfedilmemiş kod olabilir, imaj temiz sayılmaz.
+*/
+
+enum class WordKind : uint8_t {
+  Unloaded,   /* hiçbir .obj bu adrese yazmıyor */
+  Code,       /* girişlerden erişilebilen komut */
+  Data,       /* komutların referans verdiği veri */
+  Unreachable /* yüklenmiş ama ne koddan ulaşılıyor ne referans veriliyor */
+};
+
+enum class EdgeKind : uint8_t {
+  Taken,       /* koşullu BR'nin dallandığı taraf */
+  Fallthrough, /* sonraki komut (JSR'den dönüş dahil) */
+  Jump         /* koşulsuz BR ya da çözülmüş JMP */
+};
+
+enum class StoreRisk : uint8_t {
+  None,     /* hedef kod değil */
+  Possible, /* işaretçi bir kod bölgesinin içini gösteriyor */
+  Unknown,  /* hedef adres çözülemedi */
+  Certain   /* hedef adres kesin olarak kod */
+};
+
+enum class ProblemKind : uint8_t {
+  InvalidOpcode,   /* RTI/RES: VM'de crash */
+  UnresolvedJump,  /* hedefi bilinmeyen JMP */
+  UnresolvedCall,  /* hedefi bilinmeyen JSRR */
+  ExecutesUnloaded, /* akış yüklenmemiş belleğe ya da cihaz yazmaçlarına düşüyor */
+  UnknownTrap,      /* GETC..HALT dışında bir TRAP vektörü */
+  CodeReadAsData    /* LD/LDI kod olarak çözülmüş bir kelimeyi okuyor */
+};
+
+struct BasicBlock {
+  uint16_t start = 0;
+  uint16_t end = 0; // dahil, bloğun son komutu
+  std::vector<std::pair<uint16_t, EdgeKind>> successors;
+};
+
+struct Function {
+  uint16_t entry = 0;
+  std::vector<uint16_t> blocks; // blok başlangıç adresleri
+  std::set<uint16_t> callees;
+  unsigned unresolved_calls = 0;
+};
+
+struct StoreSite {
+  uint16_t pc = 0;
+  std::optional<uint16_t> target; // kesin hedef biliniyorsa
+  StoreRisk risk = StoreRisk::None;
+};
+
+struct Problem {
+  uint16_t pc = 0;
+  ProblemKind kind = ProblemKind::InvalidOpcode;
+};
+
+// "ADD R1, R1, #-1", "BRnz x3005", "TRAP PUTS" gibi
+[[nodiscard]] std::string disassemble(uint16_t address, uint16_t instr);
+
+class ImageAnalyzer {
+public:
+  ImageAnalyzer(std::shared_ptr<const Memory> memory, std::vector<ImageSegment> segments);
+
+  void analyze(const std::vector<uint16_t> &entries);
+
+  void write_json(std::ostream &out) const;
+  void write_dot(std::ostream &out) const;
+
+  // Kesin ya da olası koda yazma yoksa ve tüm store'lar çözüldüyse true
+  [[nodiscard]] bool free_of_self_modification() const;
+
+private:
+  // Yazmaç değeri için dataflow kafesi: Const < Pointer < Unknown
+  struct Value {
+    enum class Tag : uint8_t { Const, Pointer, Unknown } tag = Tag::Unknown;
+    uint16_t value = 0; // Const: değer, Pointer: işaret edilen (yüklenmiş) bölgenin (run) numarası
+    // Const: LEA'dan ya da yüklenmiş bir adresi tutan LD'den geldi, işaretçi tabanı olabilir
+    bool address = false;
+
+    bool operator==(const Value &) const = default;
+  };
+  using RegState = std::array<Value, 8>;
+
+  // Yazmacın fonksiyon girişindeki değerine göre hali, kötüleşen sırayla.
+  // Hem fonksiyon özeti hem de özet çıkarılırken fonksiyon içindeki durum.
+  enum class Effect : uint8_t {
+    Replaced,     /* girişteki değer kalmadı, değer assigned */
+    Offset,       /* giriş değeri + delta (0 ise korunuyor) */
+    SelfRelative, /* giriş değeri + bilinmeyen, aynı bölgede */
+    Clobbered
+  };
+  struct RegEffect {
+    Effect effect = Effect::Offset;
+    uint16_t delta = 0;
+    // bazı yollarda LD/LEA ile atanan değer; sonuç iki olasılıktan biri
+    std::optional<Value> assigned;
+
+    bool operator==(const RegEffect &) const = default;
+  };
+  using Summary = std::array<RegEffect, 8>;
+
+  std::shared_ptr<const Memory> memory;
+  std::vector<ImageSegment> segments;
+  std::vector<uint16_t> entries;
+
+  std::vector<bool> loaded;
+  std::vector<WordKind> kinds;
+  std::vector<bool> leaders;
+  // aynı türden (kod / kod değil) ardışık yüklenmiş kelimeler bir "run"
+  std::vector<uint16_t> run_of;
+  std::vector<bool> run_is_code;
+  std::vector<uint16_t> run_start;
+
+  std::set<uint16_t> function_entries;
+  std::set<std::pair<uint16_t, uint16_t>> indirect_targets; // dataflow ile çözülen (pc, hedef)
+  std::vector<uint16_t> pointer_refs; // LDR/STR/PUTS'un işaretçiyle eriştiği adresler
+
+  std::vector<BasicBlock> blocks;
+  std::vector<int> block_at; // adres -> blocks indeksi (sadece blok başları)
+  std::vector<Function> functions;
+  std::map<uint16_t, Summary> summaries; // sadece RET'e ulaşan fonksiyonlar: giriş -> etki
+  std::vector<StoreSite> stores;
+  std::vector<Problem> problems;
+  // Bir store'un yazabildiği kelimeler; LD/STI bunların imajdaki değerine güvenmiyor.
+  // Turlar boyunca sadece büyüyor. Hedefi bilinmeyen store her kelimeye yazabilir.
+  std::vector<bool> written;
+  bool unresolved_store = false;
+
+  [[nodiscard]] uint16_t word(uint16_t address) const { return (*memory)[address]; }
+  [[nodiscard]] bool is_code(uint16_t address) const { return kinds[address] == WordKind::Code; }
+  // Kelimenin imajdaki değeri çalışırken de geçerli mi (yüklenmiş ve hiçbir store yazamıyor)
+  [[nodiscard]] bool stable(uint16_t address) const {
+    return loaded[address] && !written[address] && !unresolved_store;
+  }
+
+  void explore(std::vector<uint16_t> worklist);
+  void build_blocks();
+  void build_runs();
+  // Sabit yayılımı. Yeni çözülen JMP/JSRR hedeflerini döner, boşsa analiz bitti.
+  [[nodiscard]] std::vector<uint16_t> propagate();
+  void build_functions();
+  void summarize();
+  // Fonksiyonun giriş durumuna göre dataflow; RET'e ulaşmıyorsa nullopt
+  [[nodiscard]] std::optional<Summary> function_summary(const Function &function) const;
+  // JSR/JSRR'nin bilinen hedefleri
+  [[nodiscard]] std::vector<uint16_t> call_targets(uint16_t pc) const;
+  // Hedeflerin birleşik özeti; hiçbiri dönmüyorsa nullopt, hedef çözülmediyse her şey bozuluyor
+  [[nodiscard]] std::optional<Summary> call_effect(uint16_t pc) const;
+  void classify_data();
+
+  // Yüklenmemiş adres için Unknown
+  [[nodiscard]] Value pointer_into(uint16_t address) const;
+  // Bilinmeyen bir indeks eklenince: işaretçi ya da adres sabiti bölgesinde kalır
+  [[nodiscard]] Value as_pointer(Value v) const;
+  [[nodiscard]] Value meet(Value a, Value b) const;
+  [[nodiscard]] Value sum(Value a, Value b) const;
+  void transfer(uint16_t pc, RegState &state) const;
+
+  [[nodiscard]] RegEffect merge(RegEffect a, const RegEffect &b) const;
+  [[nodiscard]] RegEffect offset(RegEffect x, uint16_t amount) const;
+  [[nodiscard]] RegEffect widen(RegEffect x) const;
+  // Çağıranın durumuna çağrılanın etkisini uygular
+  [[nodiscard]] RegEffect compose(const RegEffect &caller, const RegEffect &callee) const;
+  void transfer_relative(uint16_t pc, Summary &state) const;
+  [[nodiscard]] StoreSite evaluate_store(uint16_t pc, const RegState &state) const;
+  // Store'un yazabileceği kelimeleri written'a ekler (STR için taban işaretçinin bölgesi)
+  void note_store(const StoreSite &site, Value base);
+};
+
+#endif // ANALYZE_H
@@ -0,0 +1,39 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <chrono>
+#include <string_view>
+
+// VM'in dış dünyaya açılan kapısı: KBSR/KBDR, GETC/IN ve OUT/PUTS/PUTSP bunun üzerinden.
+// Normalde terminal, fuzzing'de bellekteki bir girdi dizisi.
+class Console {
+public:
+  virtual ~Console() = default;
+
+  [[nodiscard]] virtual bool key_ready() = 0;
+  // Tuş gelene kadar en fazla timeout bekler. Varsayılan beklemeden key_ready'ye bakıyor.
+  [[nodiscard]] virtual bool wait_ready(std::chrono::milliseconds /*timeout*/) { return key_ready(); }
+  [[nodiscard]] virtual int get() = 0;
+  virtual void put(char c) = 0;
+  virtual void flush() = 0;
+
+  // Girdi bitti ve bir daha gelmeyecek mi? Terminalde hiçbir zaman.
+  [[nodiscard]] virtual bool at_end() const { return false; }
+
+  // Geçersiz opcode gibi VM hataları
+  virtual void fault(std::string_view message);
+};
+
+class TerminalConsole : public Console {
+public:
+  [[nodiscard]] bool key_ready() override;
+  [[nodiscard]] bool wait_ready(std::chrono::milliseconds timeout) override;
+  [[nodiscard]] int get() override;
+  void put(char c) override;
+  void flush() override;
+
+  // tüm VM'lerin varsayılan konsolu
+  [[nodiscard]] static TerminalConsole &instance();
+};
+
+#endif // CONSOLE_H
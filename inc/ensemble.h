@@ -0,0 +1,98 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include "vm.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/*
+Lockstep ensemble: aynı imajı farklı girdilerle koşturan ENSEMBLE_LANES tane VM.
+Yazmaçlar structure-of-arrays (reg[R][lane]) tutuluyor, 16 lane x 16 bit bir AVX2
+yazmacına tam oturuyor.
+
+Her adımda aktif lane'lerin en küçük PC'si seçiliyor (min-PC), o PC'deki lane'ler
+aynı komutu birlikte çalıştırıyor, diğerleri maskeleniyor. Dallanmada ayrılan lane'ler
+döngü başı ya da birleşme noktasında tekrar aynı PC'ye gelince yeniden gruplanıyor.
+
+  - ADD/AND/NOT/LEA/BR/JMP/JSR ve bayraklar AVX2 ile, LD/LDR/LDI gather ile.
+  - AVX2'de scatter yok, ST/STR/STI lane lane yazılıyor.
+  - TRAP ve cihaz yazmaçlarına (>= 0xFE00) dokunan komutlar lane lane skaler yoldan.
+  - AVX2 olmayan hostta her şey skaler yoldan, sonuçlar aynı.
+
+Her lane'in girdisi FuzzConsole gibi: KBSR/GETC/IN buradan okur, girdi bitince lane
+InputExhausted ile durur. Zamanlayıcı ve SMP yazmaçları burada düz bellek.
+*/
+
+inline constexpr int ENSEMBLE_LANES = 16;
+// Her bu kadar grup adımında bir min-PC yerine en geride kalan lane seçiliyor
+inline constexpr uint64_t FAIRNESS_PERIOD = 64;
+
+class Ensemble {
+public:
+  // Tüm lane'ler aynı snapshot'tan başlar (VirtualMachine::snapshot / run_to_input).
+  explicit Ensemble(const Snapshot &start);
+
+  void set_input(int lane, std::span<const uint8_t> data);
+  // Lane'i hiç çalıştırma (16'dan az girdi olduğunda)
+  void disable(int lane);
+  // AVX2 olsa bile skaler yol (karşılaştırma için)
+  void force_scalar() { use_simd = false; }
+
+  // Tüm lane'ler durana ya da max_steps grup adımı dolana kadar. Dolduğunda hala
+  // çalışan lane'ler CycleLimit ile durur.
+  void run(uint64_t max_steps);
+
+  [[nodiscard]] StopReason stopped_by(int lane) const { return reasons[lane]; }
+  [[nodiscard]] uint64_t instructions(int lane) const { return retired[lane]; }
+  [[nodiscard]] const std::string &output(int lane) const { return outputs[lane]; }
+
+  [[nodiscard]] uint64_t group_steps() const { return steps; }
+  [[nodiscard]] uint64_t vector_steps() const { return simd_steps; }
+  [[nodiscard]] static bool simd_available();
+
+private:
+  // SoA: reg[R][lane]
+  alignas(32) std::array<std::array<uint16_t, ENSEMBLE_LANES>, to_underlying(Register::COUNT)> reg{};
+  alignas(32) std::array<uint64_t, ENSEMBLE_LANES> retired{};
+
+  // lane-major: lane i'nin belleği memory[i * MEMORY_MAX ...]. Sondaki 2 kelime gather'ın
+  // 32 bit okumasının taşmaması için.
+  std::vector<uint16_t> memory;
+
+  std::array<std::vector<uint8_t>, ENSEMBLE_LANES> inputs;
+  std::array<size_t, ENSEMBLE_LANES> input_positions{};
+  std::array<std::string, ENSEMBLE_LANES> outputs;
+  std::array<StopReason, ENSEMBLE_LANES> reasons{};
+
+  uint32_t active = 0; // çalışan lane'lerin bit maskesi
+  uint64_t steps = 0;
+  uint64_t simd_steps = 0;
+  bool use_simd = false;
+
+  [[nodiscard]] uint16_t &cell(int lane, uint16_t address) {
+    return memory[static_cast<size_t>(lane) * MEMORY_MAX + address];
+  }
+  [[nodiscard]] uint16_t &lane_reg(Register r, int lane) { return reg[to_underlying(r)][lane]; }
+
+  [[nodiscard]] uint16_t read(int lane, uint16_t address);
+  void update_flags(int lane, uint16_t r);
+  void stop(int lane, StopReason reason);
+
+  [[nodiscard]] int starved_lane() const;
+  void step_lane(int lane);
+  void execute_lane(int lane, uint16_t instr);
+  void trap_lane(int lane, uint16_t instr);
+
+  // Bir grup adımı: min-PC seç, o PC'deki lane'leri çalıştır
+  void step_scalar();
+  void step_simd();
+  // false: komut TRAP ya da cihaz yazmacına dokunuyor, çağıran skaler yola düşmeli.
+  // false döndüğünde hiçbir durum değişmemiş olur.
+  [[nodiscard]] bool execute_group_simd(uint32_t mask, uint16_t instr, uint16_t next_pc);
+};
+
+#endif // ENSEMBLE_H
@@ -0,0 +1,96 @@
+#ifndef FUZZ_H
+#define FUZZ_H
+
+#include "console.h"
+#include "vm.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+/*
+Snapshot tabanlı fork server:
+  1. İmaj ilk giriş isteğine (KBSR/GETC/IN) kadar bir kere koşturulur, snapshot alınır.
+  2. Her test girdisi için VM snapshot'a döner (sadece kirli sayfalar sıfırlanır),
+     girdi klavyeden geliyormuş gibi beslenir.
+  3. Geçersiz opcode = crash, cycle bütçesini aşmak = hang (kaçak döngü),
+     girdinin bitmesi = normal bitiş.
+  4. BR/JMP/JSR kenarları kapsam haritasına sayılır, yeni kenar bulan girdi
+     korpusa eklenir. Her çekirdekte bir worker thread çalışır.
+*/
+
+using FuzzInput = std::vector<uint8_t>;
+
+// Girdiyi bellekteki bir diziden veren, çıktıyı yutan konsol
+class FuzzConsole : public Console {
+public:
+  void feed(std::span<const uint8_t> data) {
+    input = data;
+    position = 0;
+  }
+
+  [[nodiscard]] bool key_ready() override { return position < input.size(); }
+  [[nodiscard]] int get() override { return position < input.size() ? input[position++] : -1; }
+  void put(char) override {}
+  void flush() override {}
+  [[nodiscard]] bool at_end() const override { return position >= input.size(); }
+  void fault(std::string_view) override {}
+
+private:
+  std::span<const uint8_t> input;
+  size_t position = 0;
+};
+
+// --max-cycles verilmezse test bütçesi en az açılış süresinin bu katı
+inline constexpr uint64_t FUZZ_BOOT_CYCLE_FACTOR = 4;
+
+struct FuzzConfig {
+  unsigned workers = 1;
+  std::chrono::seconds duration{10};
+  uint64_t max_execs = 0;        // 0 = süre dolana kadar
+  // Test başına bütçe, aşılırsa hang. rogue 256 tuşluk girdide ~5M cycle harcıyor.
+  // lc3-fuzz bunu snapshot'a kadar geçen sürenin FUZZ_BOOT_CYCLE_FACTOR katına da çıkarıyor.
+  uint64_t max_cycles = 20'000'000;
+  size_t max_input = 256;
+  uint64_t seed = 0;
+  std::filesystem::path output_dir; // boşsa crash/hang kaydedilmez
+  std::vector<FuzzInput> seeds;
+};
+
+class Fuzzer {
+public:
+  Fuzzer(Snapshot snapshot, FuzzConfig config);
+
+  // Süre ya da exec sayısı dolana kadar worker'ları çalıştırır, her saniye durum yazar.
+  // Crash bulunduysa 1 döner.
+  [[nodiscard]] int run();
+
+private:
+  Snapshot snapshot;
+  FuzzConfig config;
+
+  // her kenar için şimdiye kadar görülen hit-count kovaları
+  std::unique_ptr<std::atomic<uint8_t>[]> virgin;
+
+  std::mutex corpus_lock;
+  std::vector<FuzzInput> corpus;
+  std::set<uint16_t> crash_sites;
+
+  std::atomic<uint64_t> execs{0};
+  std::atomic<uint64_t> edges{0};
+  std::atomic<uint64_t> crashes{0};
+  std::atomic<uint64_t> hangs{0};
+
+  void worker(std::stop_token stop, unsigned id);
+  [[nodiscard]] bool merge_coverage(const uint8_t *trace);
+  void save(const char *kind, uint64_t id, const FuzzInput &input) const;
+};
+
+#endif // FUZZ_H
@@ -0,0 +1,78 @@
+#ifndef SMP_H
+#define SMP_H
+
+#include "vm.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+SMP modu: N tane LC-3 çekirdeği ayrı host thread'lerinde çalışıyor, 64K bellek
+ortak. Her çekirdeğin kendi reg dosyası ve PC'si var, hepsi PC_START'tan başlıyor;
+misafir program CPUID'yi okuyarak kendi işini seçiyor.
+
+Bellek sıralaması (memory ordering):
+  - Sıradan LD/LDR/LDI/ST/STR/STI erişimleri acquire/release. Bir çekirdeğin
+    yaptığı yazmalar, o yazmayı gören diğer çekirdekte program sırasıyla görünür.
+  - ATTAS/ATCAS okumaları seq_cst (tam bariyer). Kilit almak için ATTAS/ATCAS,
+    bırakmak için kilit adresine düz ST 0 yeterli.
+  - Mailbox kuyrukları mutex ile korunuyor; gönderilen değer alıcıda
+    göndericinin önceki yazmalarından sonra görünür.
+
+Klavye: KBSR/KBDR her çekirdekte ayrı bir mandal (mailbox yazmaçları gibi), bir
+çekirdeğin KBSR'de yakaladığı tuşu başka çekirdeğin yoklaması ezemez. Bir tuşu
+aynı anda yalnızca bir çekirdek okuyabilir (input_lock). GETC/IN'de bekleyen
+çekirdek varken diğerlerinin KBSR yoklaması bloklanmadan 0 döner.
+
+Bir çekirdek hatayla durursa (geçersiz opcode) stopping kalkar ve diğerleri
+SMP_STOP_CHECK_CYCLES içinde durur; GETC/IN'de tuş bekleyen çekirdek de en geç
+SMP_INPUT_POLL sonra bırakır.
+*/
+
+// Çekirdeklerin stopping bayrağına bakma aralığı; sıcak döngüde atomik okuma yok
+inline constexpr uint64_t SMP_STOP_CHECK_CYCLES = 1 << 16;
+// GETC/IN'de tuş beklerken stopping'e bakma aralığı
+inline constexpr std::chrono::milliseconds SMP_INPUT_POLL{50};
+
+struct Mailbox {
+  std::mutex lock;
+  std::deque<uint16_t> inbox;
+};
+
+struct SmpBus {
+  explicit SmpBus(uint16_t cores) : core_count(cores), mailboxes(cores) {}
+
+  uint16_t core_count;
+  std::vector<Mailbox> mailboxes;
+  // terminal çıktısı tüm çekirdeklerde ortak; sadece yazarken tutuluyor
+  std::mutex console_lock;
+  // klavyeden tuş okuma; çıktıyı bekletmesin diye ayrı
+  std::mutex input_lock;
+
+  std::atomic<bool> stopping{false};
+  // execute()'tan henüz çıkmamış çekirdekler; HALT mesajını son çıkan yazıyor
+  std::atomic<uint16_t> running_cores{0};
+};
+
+class SmpMachine {
+public:
+  explicit SmpMachine(uint16_t core_count);
+
+  [[nodiscard]] int run(int argc, const char *argv[]);
+
+  void set_timing(const TimingConfig &config);
+  // her çekirdek sunucuda ayrı bir VM olarak görünür (id = CPUID)
+  void set_telemetry(TelemetryServer &server);
+
+private:
+  std::shared_ptr<Memory> memory;
+  SmpBus bus;
+  std::vector<std::unique_ptr<VirtualMachine>> cores;
+};
+
+#endif // SMP_H
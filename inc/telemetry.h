@@ -0,0 +1,94 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Canlı telemetri: her VM'in sayaçları Unix domain soketinden okunabiliyor.
+
+  socat - UNIX-CONNECT:/tmp/lc3.sock
+
+Bağlanan istemciye o anki durum JSON olarak yazılıp bağlantı kapatılıyor.
+
+VM sıcak döngüde hiçbir atomik işlem yapmıyor. Sayaçlar VM'in kendi düz
+alanlarında tutuluyor ve TELEMETRY_PUBLISH_CYCLES'ta bir (next_sync noktalarında),
+girdi beklemeye başlamadan önce ve durunca buraya relaxed store ile kopyalanıyor.
+Okuyan taraf (soket thread'i) da relaxed load yapıyor; alanlar birbirine göre
+en fazla bir yayın aralığı kadar tutarsız olabilir, izleme için bu yeterli.
+*/
+
+// ~birkaç ms'de bir yayın (turbo modda), throttled modda her senkron noktasında
+inline constexpr uint64_t TELEMETRY_PUBLISH_CYCLES = 1 << 22;
+
+enum class VmState : uint8_t {
+  Idle,         /* henüz çalışmadı */
+  Running,      /* komut çalıştırıyor */
+  WaitingInput, /* GETC/IN'de tuş bekliyor */
+  Stopped       /* HALT, hata ya da limit */
+};
+
+// GETC..HALT (0x20..0x25) ve bilinmeyen vektörler
+inline constexpr size_t TELEMETRY_TRAP_SLOTS = 7;
+
+// Bir VM'in yayınlanan sayaçları. Çekirdekler ayrı cache satırlarına yazsın diye hizalı.
+struct alignas(64) VmTelemetry {
+  std::atomic<VmState> state{VmState::Idle};
+  std::atomic<uint16_t> pc{0};
+  std::atomic<uint64_t> instructions{0};
+  std::atomic<uint64_t> cycles{0};
+  std::atomic<uint64_t> output_bytes{0};
+  std::atomic<uint64_t> input_polls{0}; // boş dönen KBSR okumaları (spin)
+  std::atomic<uint64_t> wait_instructions{0}; // KBSR yoklarken çalışan komutlar, MIPS'e sayılmıyor
+  std::array<std::atomic<uint64_t>, TELEMETRY_TRAP_SLOTS> traps{};
+
+  // steady_clock nanosaniye
+  std::atomic<int64_t> started_ns{0};
+  std::atomic<int64_t> published_ns{0}; // son yayın; durduysa duruş anı
+  std::atomic<int64_t> input_wait_ns{0};  // tamamlanmış beklemelerin toplamı
+  std::atomic<int64_t> wait_started_ns{0}; // state == WaitingInput ise
+  std::atomic<double> current_mips{0.0};   // son yayın aralığındaki hız
+};
+
+[[nodiscard]] inline int64_t telemetry_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+class TelemetryServer {
+public:
+  // Soketi açar ve dinlemeye başlar; açılamazsa ya da yolda soket olmayan bir dosya
+  // varsa std::runtime_error.
+  explicit TelemetryServer(std::filesystem::path path);
+  ~TelemetryServer();
+
+  TelemetryServer(const TelemetryServer &) = delete;
+  TelemetryServer &operator=(const TelemetryServer &) = delete;
+
+  // Yeni bir VM için sayaç alanı. Sunucu yok edilene kadar geçerli.
+  [[nodiscard]] VmTelemetry &attach();
+
+private:
+  std::filesystem::path path;
+  int listen_fd = -1;
+
+  std::mutex slots_lock;
+  std::vector<std::unique_ptr<VmTelemetry>> slots;
+
+  std::jthread thread; // en son: yıkımda önce bu durup join ediliyor
+
+  void serve(std::stop_token stop);
+  [[nodiscard]] std::string report();
+};
+
+#endif // TELEMETRY_H
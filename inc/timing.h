@@ -0,0 +1,70 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+// Her opcode'un sanal saatte kaç cycle tuttuğu (komut okuma dahil).
+// Bellek erişimi olan komutlar pahalı, LDI/STI iki kere belleğe gittiği için daha da pahalı.
+inline constexpr std::array<uint8_t, 16> OPCODE_CYCLES = {
+    2, // BR
+    1, // ADD
+    3, // LD
+    3, // ST
+    2, // JSR
+    1, // AND
+    3, // LDR
+    3, // STR
+    1, // RTI (geçersiz)
+    1, // NOT
+    5, // LDI
+    5, // STI
+    2, // JMP
+    1, // RES (geçersiz)
+    1, // LEA
+    8  // TRAP
+};
+
+// TMIR birimi: zamanlayıcı aralığı bu kadar cycle'ın katı olarak veriliyor
+inline constexpr uint64_t TIMER_TICK_CYCLES = 1000;
+
+inline constexpr uint64_t NO_SYNC = std::numeric_limits<uint64_t>::max();
+
+enum class ExecutionMode {
+  Turbo,    /* host ne kadar izin verirse o kadar hızlı */
+  Throttled /* sabit hedef frekansta, büyük parçalar halinde uyuyarak */
+};
+
+struct TimingConfig {
+  ExecutionMode mode = ExecutionMode::Turbo;
+  double target_mhz = 0.0;
+  bool report = false; // çıkışta sanal cycle ve efektif MHz yazdır
+};
+
+class Timing {
+public:
+  Timing() = default;
+  // Throttled modda hedef frekans pozitif ve sonlu değilse std::invalid_argument
+  explicit Timing(const TimingConfig &config);
+
+  // Çalışmanın başladığı anı kaydeder, ilk senkron noktasını döner.
+  [[nodiscard]] uint64_t start(uint64_t cycles);
+
+  // Sanal saat host saatinin önündeyse uyur. Bir sonraki senkron noktasını döner.
+  [[nodiscard]] uint64_t sync(uint64_t cycles);
+
+  void report(uint64_t cycles, uint64_t instructions) const;
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  TimingConfig config{};
+  uint64_t chunk_cycles = 0;
+  uint64_t base_cycles = 0;
+  clock::time_point base_time{};
+  clock::time_point start_time{};
+};
+
+#endif // TIMING_H
@@ -12,7 +12,14 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <vector>
+
+#include "console.h"
+#include "telemetry.h"
+#include "timing.h"
 
 #include <fcntl.h>
 #include <sys/select.h>
@@ -23,6 +30,16 @@
 inline constexpr int MEMORY_MAX = 1 << 16;
 inline constexpr uint32_t PC_START = 0x3000;
 
+using Memory = std::array<uint16_t, MEMORY_MAX>;
+
+// Copy-on-write için bellek 512 kelimelik (1 KiB) sayfalara bölünüyor.
+inline constexpr int PAGE_BITS = 9;
+inline constexpr int PAGE_WORDS = 1 << PAGE_BITS;
+inline constexpr int PAGE_COUNT = MEMORY_MAX / PAGE_WORDS;
+inline constexpr uint16_t PAGE_MASK = PAGE_WORDS - 1;
+
+using Page = std::array<uint16_t, PAGE_WORDS>;
+
 // little endian - big endian dönüşümü için yapılıyor.
 // c++23 bitswap kullandığım için bunu kullanmadım.
 constexpr uint16_t swap16(uint16_t x) {
@@ -88,7 +105,25 @@ enum class ConditionFlag : uint16_t {
 
 enum class MemoryMappedRegister : uint16_t {
   KBSR = 0xFE00, /* keyboard status */
-  KBDR = 0xFE02  /* keyboard data */
+  KBDR = 0xFE02, /* keyboard data */
+
+  // SMP modunda çekirdek başına görünen yazmaçlar (smp.h)
+  CPUID = 0xFE10, /* core id (read only) */
+  NCPU = 0xFE12,  /* core count (read only) */
+  MBSR = 0xFE14,  /* mailbox status, bit 15 = inbox not empty */
+  MBDR = 0xFE16,  /* mailbox data: read pops own inbox, write sends to MBDST */
+  MBDST = 0xFE18, /* mailbox destination core */
+  ATAR = 0xFE20,  /* atomic device: target address */
+  ATEXP = 0xFE22, /* atomic device: expected value for CAS */
+  ATNEW = 0xFE24, /* atomic device: new value for CAS */
+  ATTAS = 0xFE26, /* read: test-and-set [ATAR], returns old value */
+  ATCAS = 0xFE28, /* read: compare-and-swap [ATAR], returns old value */
+
+  // sanal saat ve zamanlayıcı (timing.h)
+  CLKLO = 0xFE30, /* read: cycle counter bits 0-15, latches bits 16-31 into CLKHI */
+  CLKHI = 0xFE32, /* cycle counter bits 16-31 as of the last CLKLO read */
+  TMSR = 0xFE34,  /* timer status, bit 15 = interval elapsed (cleared on read) */
+  TMIR = 0xFE36   /* timer interval in TIMER_TICK_CYCLES units, 0 = off */
 };
 
 // Helper to convert enum class to underlying type
@@ -97,11 +132,109 @@ constexpr auto to_underlying(E e) noexcept {
   return static_cast<std::underlying_type_t<E>>(e);
 }
 
+// Tüm cihaz yazmaçları bu adresin üstünde; altı her zaman düz bellek.
+inline constexpr uint16_t MMIO_BEGIN = to_underlying(MemoryMappedRegister::KBSR);
+
+// SMP yazmaçlarının kapladığı adres aralığı. Tek çekirdekte bu adresler düz bellek gibi davranır.
+inline constexpr uint16_t SMP_MMIO_BEGIN = to_underlying(MemoryMappedRegister::CPUID);
+inline constexpr uint16_t SMP_MMIO_END = to_underlying(MemoryMappedRegister::ATCAS);
+
+inline constexpr uint16_t TIMER_MMIO_BEGIN = to_underlying(MemoryMappedRegister::CLKLO);
+inline constexpr uint16_t TIMER_MMIO_END = to_underlying(MemoryMappedRegister::TMIR);
+
+// Fuzzing kenar kapsamı haritası: BR/JMP/JSR hedefleri buraya sayılıyor (AFL tarzı).
+inline constexpr size_t COVERAGE_MAP_SIZE = 1 << 16;
+
+// execute() neden döndü
+enum class StopReason {
+  None,
+  Halt,           /* TRAP HALT */
+  InvalidOpcode,  /* RTI/RES */
+  InputExhausted, /* konsolun girdisi bitti ve program yenisini istedi */
+  InputBarrier,   /* run_to_input: ilk giriş isteğinde durduk */
+  CycleLimit,     /* set_cycle_limit ile verilen bütçe doldu */
+  PeerFault       /* SMP: başka bir çekirdek hatayla durdu */
+};
+
+// Belleğin ve CPU'nun bir andaki hali. memory değişmez ve paylaşılabilir,
+// restore edilen VM'ler copy-on-write ile ondan devam eder.
+struct Snapshot {
+  std::shared_ptr<const Memory> memory;
+  std::array<uint16_t, to_underlying(Register::COUNT)> reg{};
+  uint64_t cycle_count = 0;
+  uint64_t instruction_count = 0;
+  uint64_t timer_interval = 0;
+  uint64_t timer_deadline = 0;
+};
+
+// read_image ile yüklenen bir .obj dosyasının kapladığı alan
+struct ImageSegment {
+  uint16_t origin = 0;
+  size_t length = 0;
+};
+
+// VM belleğe nasıl erişiyor. execute() döngüsü her mod için ayrı derleniyor,
+// böylece düz VM sayfa tablosu ve SMP kontrollerinin bedelini ödemiyor.
+enum class MemoryMode {
+  Flat,  /* tek VM, snapshot'tan açılmamış: doğrudan memory[address] */
+  Paged, /* snapshot/imaj paylaşan VM: sayfa tabloları ve copy-on-write */
+  Shared /* SMP çekirdeği: ortak bellek, atomic_ref ile */
+};
+
+// execute() sıcak döngüsünün sayaçları. Döngü boyunca yerel tutuluyor, VM üyelerine
+// sadece senkron noktalarında ve cihaz/TRAP yavaş yoluna girmeden önce yazılıyor.
+struct LiveCounters {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+};
+
+struct SmpBus;
+
 class VirtualMachine {
 public:
+  // Tek başına VM: kendi düz belleğiyle başlıyor (MemoryMode::Flat). Snapshot'a
+  // restore edilirse sayfalı moda geçer.
+  VirtualMachine();
+  // Aynı imajdan açılan VM'ler image'ın sayfalarını paylaşır, bir sayfa ancak
+  // ilk yazmada o VM'e özel kopyalanır.
+  explicit VirtualMachine(std::shared_ptr<const Memory> image);
+  // SMP çekirdeği: bellek diğer çekirdeklerle paylaşılıyor, reg ve PC bu nesneye ait.
+  VirtualMachine(std::shared_ptr<Memory> shared_memory, SmpBus *bus, uint16_t core_id);
+
+  VirtualMachine(const VirtualMachine &) = delete;
+  VirtualMachine &operator=(const VirtualMachine &) = delete;
 
   [[nodiscard]] int run(int argc, const char *argv[]);
 
+  [[nodiscard]] bool load_images(int argc, const char *argv[]);
+  void reset();
+  [[nodiscard]] int execute();
+
+  void set_timing(const TimingConfig &config);
+
+  // Belleğin o anki halini yeni VM'lerin paylaşabileceği değişmez bir imaja çevirir.
+  [[nodiscard]] std::shared_ptr<const Memory> snapshot_memory() const;
+  // Bu VM'e özel kopyalanmış (kirli) sayfa sayısı
+  [[nodiscard]] size_t private_page_count() const;
+
+  // Programı ilk giriş isteğine (KBSR, GETC, IN) kadar koşturur ve o komutun öncesinde
+  // durur. max_cycles içinde giriş istenmezse false.
+  [[nodiscard]] bool run_to_input(uint64_t max_cycles);
+  [[nodiscard]] Snapshot snapshot() const;
+  // Snapshot'a döner. Aynı snapshot'a tekrar dönülüyorsa sadece kirli sayfalar sıfırlanır.
+  void restore(const Snapshot &snapshot);
+
+  void set_console(Console &new_console) { console = &new_console; }
+  void set_cycle_limit(uint64_t limit) { cycle_limit = limit; }
+  void set_coverage(uint8_t *map) { coverage = map; }
+  // Sayaçları bu alana yayınla (telemetry.h). VM'den uzun yaşamalı.
+  void set_telemetry(VmTelemetry &slot) { telemetry = &slot; }
+  [[nodiscard]] StopReason stopped_by() const { return stop_reason; }
+  [[nodiscard]] uint16_t pc() const { return reg[to_underlying(Register::PC)]; }
+  [[nodiscard]] const std::vector<ImageSegment> &loaded_segments() const { return segments; }
+  // "VM durduruluyor." mesajı; SMP'de son çekirdek çıkınca SmpMachine çağırıyor
+  void announce_halt();
+
 
   [[nodiscard]] bool read_image(const std::filesystem::path &path);
 
@@ -114,14 +247,117 @@ public:
   void update_flags(uint16_t r);
 
 private:
-  std::array<uint16_t, MEMORY_MAX> memory{};
+  // Sayfa tabloları: Paged modda okuma her zaman read_pages üzerinden. write_pages[i] == nullptr
+  // ise sayfa hala image'dan paylaşılıyor ve ilk yazmada kopyalanacak. Flat ve Shared
+  // modlarında tablolar sadece memory'nin sayfalarını gösteriyor (snapshot_memory için).
+  MemoryMode memory_mode = MemoryMode::Paged;
+  std::shared_ptr<const Memory> image;
+  std::shared_ptr<Memory> memory; // Flat: VM'in kendi belleği, Shared: çekirdeklerin ortak belleği
+  uint16_t *memory_words = nullptr; // memory->data(), sıcak yolda shared_ptr'den geçmemek için
+  std::array<const uint16_t *, PAGE_COUNT> read_pages{};
+  std::array<uint16_t *, PAGE_COUNT> write_pages{};
+  std::array<std::unique_ptr<Page>, PAGE_COUNT> private_pages;
+  std::vector<ImageSegment> segments;
   std::array<uint16_t, to_underlying(Register::COUNT)> reg{};
   uint16_t instr = 0;
   uint16_t op = 0;
   bool running = true;
+  StopReason stop_reason = StopReason::None;
+
+  Console *console = &TerminalConsole::instance();
+  bool input_barrier = false;
+  uint64_t cycle_limit = NO_SYNC;
+  uint8_t *coverage = nullptr;
+
+  // sanal saat; execute() sırasında LiveCounters'ın son senkron noktasındaki hali
+  uint64_t cycle_count = 0;
+  uint64_t instruction_count = 0;
+  uint64_t next_sync = NO_SYNC; // min(next_timing_sync, next_publish, next_stop_check, cycle_limit)
+  uint64_t next_timing_sync = NO_SYNC;
+  Timing timing;
+  uint16_t clock_high_latch = 0;
+  uint64_t timer_interval = 0;
+  uint64_t timer_deadline = 0;
+
+  // telemetri; sayaçlar burada düz tutulup publish() ile kopyalanıyor
+  VmTelemetry *telemetry = nullptr;
+  uint64_t next_publish = NO_SYNC;
+  uint64_t output_bytes = 0;
+  uint64_t input_polls = 0;
+  std::array<uint64_t, TELEMETRY_TRAP_SLOTS> trap_counts{};
+  int64_t input_wait_ns = 0;
+  int64_t poll_wait_began_ns = 0; // boş KBSR yoklamasıyla başlayan bekleme, 0 = yok
+  uint64_t poll_wait_began_instructions = 0;
+  uint64_t wait_instructions = 0; // tamamlanmış yoklama beklemelerinde çalışan komutlar
+  uint64_t published_instructions = 0;
+  int64_t published_ns = 0;
+
+  // SMP durumu; tek çekirdekte bus == nullptr
+  SmpBus *bus = nullptr;
+  uint16_t core_id = 0;
+  uint16_t mailbox_target = 0;
+  uint16_t atomic_address = 0;
+  uint16_t atomic_expected = 0;
+  uint16_t atomic_new = 0;
+  uint64_t next_stop_check = NO_SYNC;
+  // çekirdeğe özel KBSR/KBDR mandalı
+  uint16_t keyboard_status = 0;
+  uint16_t keyboard_data = 0;
 
   void read_image_file(std::ifstream &file);
 
+  // next_sync'e gelindi: limit, SMP durdurma, saat ve telemetri. Durulacaksa false.
+  [[nodiscard]] bool sync_point(LiveCounters &live);
+  template <MemoryMode Mode> [[nodiscard]] int run_loop(LiveCounters &live);
+  template <MemoryMode Mode> [[nodiscard]] bool step(LiveCounters &live);
+  [[nodiscard]] bool step(LiveCounters &live);
+  void sync_counters(const LiveCounters &live) {
+    cycle_count = live.cycles;
+    instruction_count = live.instructions;
+  }
+  void stop(StopReason reason);
+  [[nodiscard]] bool input_pending();
+  // GETC/IN için bloklayan okuma, bekleme süresi telemetriye sayılıyor.
+  // SMP'de başka çekirdek hatayla durursa PeerFault ile döner.
+  [[nodiscard]] int wait_key();
+  [[nodiscard]] int read_key();
+  // KBSR yoklamasıyla başlamış beklemeyi kapatıp input_wait_ns'e ekler
+  void end_poll_wait();
+  void emit(char c) {
+    console->put(c);
+    ++output_bytes;
+  }
+  void publish(VmState state);
+  // SMP'de ortak konsol kilitleri, tek çekirdekte boş kilit
+  [[nodiscard]] std::unique_lock<std::mutex> lock_output();
+  [[nodiscard]] std::unique_lock<std::mutex> lock_input();
+
+  void record_edge(uint16_t from, uint16_t to) {
+    if (coverage != nullptr) {
+      ++coverage[((static_cast<uint32_t>(from) * 0x9E37u) ^ to) & (COVERAGE_MAP_SIZE - 1)];
+    }
+  }
+
+  // MMIO'yu atlayan ham bellek erişimi; şablonsuz halleri memory_mode'a göre seçiyor
+  template <MemoryMode Mode> [[nodiscard]] uint16_t load(uint16_t address);
+  template <MemoryMode Mode> void store(uint16_t address, uint16_t val);
+  [[nodiscard]] uint16_t load(uint16_t address);
+  void store(uint16_t address, uint16_t val);
+  // komutların bellek erişimi: MMIO_BEGIN altı doğrudan load/store, üstü sayaçları
+  // yazıp cihaz yoluna gidiyor
+  template <MemoryMode Mode> [[nodiscard]] uint16_t mem_read(uint16_t address, LiveCounters &live);
+  template <MemoryMode Mode> void mem_write(uint16_t address, uint16_t val, LiveCounters &live);
+  // tüm cihaz yazmaçları (klavye, SMP, saat); sadece address >= MMIO_BEGIN
+  [[nodiscard]] uint16_t mmio_read(uint16_t address);
+  void mmio_write(uint16_t address, uint16_t val);
+  [[nodiscard]] uint16_t *copy_page(size_t page);
+
+  [[nodiscard]] uint16_t smp_mmio_read(uint16_t address);
+  void smp_mmio_write(uint16_t address, uint16_t val);
+
+  [[nodiscard]] uint16_t timer_mmio_read(uint16_t address);
+  void timer_mmio_write(uint16_t address, uint16_t val);
+
 
   void process_ADD(uint16_t instr);
   void process_AND(uint16_t instr);
@@ -129,13 +365,13 @@ private:
   void process_BR(uint16_t instr);
   void process_JMP(uint16_t instr);
   void process_JSR(uint16_t instr);
-  void process_LD(uint16_t instr);
-  void process_LDI(uint16_t instr);
-  void process_LDR(uint16_t instr);
+  template <MemoryMode Mode> void process_LD(uint16_t instr, LiveCounters &live);
+  template <MemoryMode Mode> void process_LDI(uint16_t instr, LiveCounters &live);
+  template <MemoryMode Mode> void process_LDR(uint16_t instr, LiveCounters &live);
   void process_LEA(uint16_t instr);
-  void process_ST(uint16_t instr);
-  void process_STI(uint16_t instr);
-  void process_STR(uint16_t instr);
+  template <MemoryMode Mode> void process_ST(uint16_t instr, LiveCounters &live);
+  template <MemoryMode Mode> void process_STI(uint16_t instr, LiveCounters &live);
+  template <MemoryMode Mode> void process_STR(uint16_t instr, LiveCounters &live);
   void process_TRAP(uint16_t instr);
 };
 
@@ -0,0 +1,1273 @@
+#include "analyze.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+static Opcode opcode_of(uint16_t instr) { return static_cast<Opcode>(instr >> 12); }
+
+static uint16_t pc_offset9(uint16_t pc, uint16_t instr) {
+  return static_cast<uint16_t>(pc + 1 + sign_extend(instr & 0x1FF, 9));
+}
+
+// Bloğu bitiren komutlar: dallanma, atlama, çağrı, HALT ve geçersiz opcode
+static bool ends_block(uint16_t instr) {
+  switch (opcode_of(instr)) {
+  case Opcode::BR:
+    return ((instr >> 9) & 0x7) != 0;
+  case Opcode::JMP:
+  case Opcode::JSR:
+  case Opcode::RTI:
+  case Opcode::RES:
+    return true;
+  case Opcode::TRAP:
+    return (instr & 0xFF) == to_underlying(Trap::HALT);
+  default:
+    return false;
+  }
+}
+
+static std::string hex(uint16_t address) {
+  std::ostringstream out;
+  out << "x" << std::uppercase << std::hex << std::setw(4) << std::setfill('0') << address;
+  return out.str();
+}
+
+static std::string quoted_hex(uint16_t address) {
+  std::string text = "\"";
+  return text.append(hex(address)).append("\"");
+}
+
+[[nodiscard]] std::string disassemble(uint16_t address, uint16_t instr) {
+  const uint16_t r0 = (instr >> 9) & 0x7;
+  const uint16_t r1 = (instr >> 6) & 0x7;
+  auto reg = [](uint16_t r) { return std::string("R").append(std::to_string(r)); };
+  auto imm = [](uint16_t value, int bits) {
+    return std::string("#").append(std::to_string(static_cast<int16_t>(sign_extend(value, bits))));
+  };
+
+  switch (opcode_of(instr)) {
+  case Opcode::BR: {
+    const uint16_t nzp = (instr >> 9) & 0x7;
+    if (nzp == 0) {
+      return "NOP";
+    }
+    std::string name = "BR";
+    if (nzp & to_underlying(ConditionFlag::NEG)) name += "n";
+    if (nzp & to_underlying(ConditionFlag::ZRO)) name += "z";
+    if (nzp & to_underlying(ConditionFlag::POS)) name += "p";
+    return name + " " + hex(pc_offset9(address, instr));
+  }
+  case Opcode::ADD:
+  case Opcode::AND: {
+    const std::string name = opcode_of(instr) == Opcode::ADD ? "ADD " : "AND ";
+    const std::string operand = ((instr >> 5) & 0x1) ? imm(instr & 0x1F, 5) : reg(instr & 0x7);
+    return name + reg(r0) + ", " + reg(r1) + ", " + operand;
+  }
+  case Opcode::NOT:
+    return "NOT " + reg(r0) + ", " + reg(r1);
+  case Opcode::LD:
+    return "LD " + reg(r0) + ", " + hex(pc_offset9(address, instr));
+  case Opcode::LDI:
+    return "LDI " + reg(r0) + ", " + hex(pc_offset9(address, instr));
+  case Opcode::ST:
+    return "ST " + reg(r0) + ", " + hex(pc_offset9(address, instr));
+  case Opcode::STI:
+    return "STI " + reg(r0) + ", " + hex(pc_offset9(address, instr));
+  case Opcode::LEA:
+    return "LEA " + reg(r0) + ", " + hex(pc_offset9(address, instr));
+  case Opcode::LDR:
+    return "LDR " + reg(r0) + ", " + reg(r1) + ", " + imm(instr & 0x3F, 6);
+  case Opcode::STR:
+    return "STR " + reg(r0) + ", " + reg(r1) + ", " + imm(instr & 0x3F, 6);
+  case Opcode::JMP:
+    return r1 == to_underlying(Register::R7) ? "RET" : "JMP " + reg(r1);
+  case Opcode::JSR:
+    if ((instr >> 11) & 0x1) {
+      return "JSR " + hex(static_cast<uint16_t>(address + 1 + sign_extend(instr & 0x7FF, 11)));
+    }
+    return "JSRR " + reg(r1);
+  case Opcode::TRAP:
+    switch (static_cast<Trap>(instr & 0xFF)) {
+    case Trap::GETC:
+      return "GETC";
+    case Trap::OUT:
+      return "OUT";
+    case Trap::PUTS:
+      return "PUTS";
+    case Trap::IN:
+      return "IN";
+    case Trap::PUTSP:
+      return "PUTSP";
+    case Trap::HALT:
+      return "HALT";
+    default:
+      return "TRAP " + hex(instr & 0xFF);
+    }
+  case Opcode::RTI:
+    return "RTI";
+  case Opcode::RES:
+  default:
+    return "RES";
+  }
+}
+
+ImageAnalyzer::ImageAnalyzer(std::shared_ptr<const Memory> memory, std::vector<ImageSegment> segments)
+    : memory(std::move(memory)), segments(std::move(segments)), loaded(MEMORY_MAX),
+      kinds(MEMORY_MAX, WordKind::Unloaded), leaders(MEMORY_MAX), written(MEMORY_MAX) {
+  for (const ImageSegment &segment : this->segments) {
+    for (size_t i = 0; i < segment.length; ++i) {
+      loaded[static_cast<uint16_t>(segment.origin + i)] = true;
+    }
+  }
+}
+
+void ImageAnalyzer::analyze(const std::vector<uint16_t> &entry_points) {
+  entries = entry_points;
+  function_entries.insert(entries.begin(), entries.end());
+  std::vector<uint16_t> worklist = entries;
+  for (uint16_t entry : entries) {
+    leaders[entry] = true;
+  }
+
+  // Dolaylı hedef çözüldükçe, bir fonksiyonun döndüğü anlaşıldıkça ya da store'ların
+  // yazabildiği kelimeler arttıkça tekrarlanıyor. Her turda kod, çözülmüş hedef ya da
+  // written kümesi büyüyor, sonlu.
+  std::set<uint16_t> return_sites;
+  bool writes_grew = false;
+  while (!worklist.empty() || writes_grew) {
+    explore(std::move(worklist));
+    build_blocks();
+    build_runs();
+    build_functions();
+    summarize();
+    const std::vector<bool> written_before = written;
+    const bool unresolved_before = unresolved_store;
+    worklist = propagate();
+    writes_grew = written != written_before || unresolved_store != unresolved_before;
+
+    for (uint32_t address = 0; address + 1 < MEMORY_MAX; ++address) {
+      const auto pc = static_cast<uint16_t>(address);
+      if (is_code(pc) && opcode_of(word(pc)) == Opcode::JSR && call_effect(pc) &&
+          return_sites.insert(static_cast<uint16_t>(pc + 1)).second) {
+        leaders[pc + 1] = true;
+        worklist.push_back(static_cast<uint16_t>(pc + 1));
+      }
+    }
+  }
+
+  build_functions();
+  classify_data();
+
+  // aynı yüklenmemiş adrese birden çok yoldan düşülmüş olabilir
+  std::sort(problems.begin(), problems.end(), [](const Problem &a, const Problem &b) {
+    return std::pair(a.pc, a.kind) < std::pair(b.pc, b.kind);
+  });
+  problems.erase(std::unique(problems.begin(), problems.end(),
+                             [](const Problem &a, const Problem &b) {
+                               return a.pc == b.pc && a.kind == b.kind;
+                             }),
+                 problems.end());
+}
+
+// ============================================================================
+// Keşif ve temel bloklar
+// ============================================================================
+
+void ImageAnalyzer::explore(std::vector<uint16_t> worklist) {
+  while (!worklist.empty()) {
+    const uint16_t start = worklist.back();
+    worklist.pop_back();
+
+    for (uint16_t pc = start;; ++pc) {
+      if (is_code(pc)) {
+        leaders[pc] = true; // başka bir yoldan zaten çözülmüş koda katıldık
+        break;
+      }
+      if (!loaded[pc] || pc >= MMIO_BEGIN) {
+        problems.push_back({.pc = pc, .kind = ProblemKind::ExecutesUnloaded});
+        break;
+      }
+
+      kinds[pc] = WordKind::Code;
+      const uint16_t instr = word(pc);
+      const auto next = static_cast<uint16_t>(pc + 1);
+      bool falls_through = true;
+
+      switch (opcode_of(instr)) {
+      case Opcode::BR: {
+        const uint16_t nzp = (instr >> 9) & 0x7;
+        if (nzp == 0) {
+          break; // NOP
+        }
+        const uint16_t target = pc_offset9(pc, instr);
+        leaders[target] = true;
+        worklist.push_back(target);
+        if (nzp == 0x7) {
+          falls_through = false;
+        } else {
+          leaders[next] = true;
+        }
+        break;
+      }
+      case Opcode::JMP:
+        // RET ya da dolaylı atlama; hedefler dataflow'dan sonra ekleniyor
+        falls_through = false;
+        break;
+      case Opcode::JSR:
+        if ((instr >> 11) & 0x1) {
+          const auto target = static_cast<uint16_t>(next + sign_extend(instr & 0x7FF, 11));
+          function_entries.insert(target);
+          leaders[target] = true;
+          worklist.push_back(target);
+        }
+        // dönüş noktası, çağrılan fonksiyonun döndüğü görülünce analyze() ekliyor;
+        // goto gibi kullanılan JSR'den sonraki veri kod sanılmasın
+        falls_through = false;
+        break;
+      case Opcode::TRAP:
+        if ((instr & 0xFF) < to_underlying(Trap::GETC) || (instr & 0xFF) > to_underlying(Trap::HALT)) {
+          problems.push_back({.pc = pc, .kind = ProblemKind::UnknownTrap});
+        }
+        falls_through = (instr & 0xFF) != to_underlying(Trap::HALT);
+        break;
+      case Opcode::RTI:
+      case Opcode::RES:
+        problems.push_back({.pc = pc, .kind = ProblemKind::InvalidOpcode});
+        falls_through = false;
+        break;
+      default:
+        break;
+      }
+
+      if (!falls_through) {
+        break;
+      }
+    }
+  }
+}
+
+void ImageAnalyzer::build_blocks() {
+  blocks.clear();
+  block_at.assign(MEMORY_MAX, -1);
+
+  for (uint32_t address = 0; address < MEMORY_MAX; ++address) {
+    const auto a = static_cast<uint16_t>(address);
+    if (!is_code(a)) {
+      continue;
+    }
+    const bool starts = leaders[a] || a == 0 || !is_code(a - 1) || ends_block(word(a - 1));
+    if (!starts) {
+      continue;
+    }
+
+    uint32_t pc = a;
+    while (!ends_block(word(static_cast<uint16_t>(pc))) && pc + 1 < MEMORY_MAX &&
+           is_code(static_cast<uint16_t>(pc + 1)) && !leaders[pc + 1]) {
+      ++pc;
+    }
+    block_at[a] = static_cast<int>(blocks.size());
+    blocks.push_back({.start = a, .end = static_cast<uint16_t>(pc), .successors = {}});
+  }
+
+  for (BasicBlock &block : blocks) {
+    const uint16_t last = word(block.end);
+    const auto next = static_cast<uint16_t>(block.end + 1);
+    const bool has_next = block.end != 0xFFFF && is_code(next);
+    auto add = [&block](uint16_t to, EdgeKind kind) { block.successors.emplace_back(to, kind); };
+
+    switch (opcode_of(last)) {
+    case Opcode::BR: {
+      const uint16_t nzp = (last >> 9) & 0x7;
+      if (nzp == 0x7) {
+        add(pc_offset9(block.end, last), EdgeKind::Jump);
+        break;
+      }
+      if (nzp != 0) {
+        add(pc_offset9(block.end, last), EdgeKind::Taken);
+      }
+      if (has_next) {
+        add(next, EdgeKind::Fallthrough);
+      }
+      break;
+    }
+    case Opcode::JMP:
+      for (const auto &[pc, target] : indirect_targets) {
+        if (pc == block.end && is_code(target)) {
+          add(target, EdgeKind::Jump);
+        }
+      }
+      break;
+    case Opcode::RTI:
+    case Opcode::RES:
+      break;
+    case Opcode::TRAP:
+      if ((last & 0xFF) == to_underlying(Trap::HALT)) {
+        break;
+      }
+      [[fallthrough]];
+    default:
+      // JSR dahil: çağrılan fonksiyon dönünce sonraki komuttan devam (dönüyorsa)
+      if (has_next && (opcode_of(last) != Opcode::JSR || call_effect(block.end))) {
+        add(next, EdgeKind::Fallthrough);
+      }
+      break;
+    }
+  }
+}
+
+void ImageAnalyzer::build_runs() {
+  run_of.assign(MEMORY_MAX, 0);
+  run_is_code.clear();
+  run_start.clear();
+  for (uint32_t address = 0; address < MEMORY_MAX; ++address) {
+    const auto a = static_cast<uint16_t>(address);
+    if (a == 0 || loaded[a] != loaded[a - 1] || is_code(a) != is_code(a - 1)) {
+      run_is_code.push_back(is_code(a));
+      run_start.push_back(a);
+    }
+    run_of[a] = static_cast<uint16_t>(run_start.size() - 1);
+  }
+}
+
+// ============================================================================
+// Sabit / işaretçi yayılımı
+// ============================================================================
+
+// Sadece yüklenmiş bölgeler: yüklenmemiş bellekte (yığın gibi) bölge sınırı yok,
+// oradaki bir işaretçi koda kadar yürüyebilir
+[[nodiscard]] ImageAnalyzer::Value ImageAnalyzer::pointer_into(uint16_t address) const {
+  if (!loaded[address]) {
+    return {};
+  }
+  return {.tag = Value::Tag::Pointer, .value = run_of[address], .address = false};
+}
+
+[[nodiscard]] ImageAnalyzer::Value ImageAnalyzer::as_pointer(Value v) const {
+  if (v.tag == Value::Tag::Pointer) {
+    return v;
+  }
+  // düz bir sayı (sayaç, tuş kodu) bir bölgeye işaret etmiyor
+  return v.tag == Value::Tag::Const && v.address ? pointer_into(v.value) : Value{};
+}
+
+[[nodiscard]] ImageAnalyzer::Value ImageAnalyzer::meet(Value a, Value b) const {
+  if (a == b) {
+    return a;
+  }
+  if (a.tag == Value::Tag::Unknown || b.tag == Value::Tag::Unknown) {
+    return {};
+  }
+  if (a.tag == Value::Tag::Const && b.tag == Value::Tag::Const && a.value == b.value) {
+    return {.tag = Value::Tag::Const, .value = a.value, .address = a.address && b.address};
+  }
+  // farklı iki adres ya da işaretçi: aynı bölgedeyseler o bölgeye bir işaretçi
+  const Value pa = as_pointer(a);
+  const Value pb = as_pointer(b);
+  if (pa.tag == Value::Tag::Pointer && pa == pb) {
+    return pa;
+  }
+  return {};
+}
+
+// ADD'in iki yazmaçlı hali
+[[nodiscard]] ImageAnalyzer::Value ImageAnalyzer::sum(Value a, Value b) const {
+  if (a.tag == Value::Tag::Const && b.tag == Value::Tag::Const) {
+    return {.tag = Value::Tag::Const,
+            .value = static_cast<uint16_t>(a.value + b.value),
+            .address = a.address || b.address};
+  }
+  // işaretçi + indeks: sonuç işaretçinin bölgesinde kalıyor sayılıyor
+  const Value pa = as_pointer(a);
+  return pa.tag == Value::Tag::Pointer ? pa : as_pointer(b);
+}
+
+[[nodiscard]] ImageAnalyzer::RegEffect ImageAnalyzer::merge(RegEffect a, const RegEffect &b) const {
+  if (a == b) {
+    return a;
+  }
+  RegEffect result = a;
+  if (a.effect == Effect::Replaced) {
+    result.effect = b.effect;
+    result.delta = b.delta;
+  } else if (b.effect == Effect::Replaced) {
+    // a'nın giriş kısmı kalıyor
+  } else if (a.effect == Effect::Clobbered || b.effect == Effect::Clobbered) {
+    result.effect = Effect::Clobbered;
+  } else if (a.effect != Effect::Offset || b.effect != Effect::Offset || a.delta != b.delta) {
+    result.effect = Effect::SelfRelative;
+  }
+
+  if (a.assigned && b.assigned) {
+    result.assigned = meet(*a.assigned, *b.assigned);
+  } else if (b.assigned) {
+    result.assigned = b.assigned;
+  }
+  if (result.effect == Effect::Clobbered ||
+      (result.assigned && result.assigned->tag == Value::Tag::Unknown)) {
+    return {.effect = Effect::Clobbered, .delta = 0, .assigned = std::nullopt};
+  }
+  if (result.effect != Effect::Offset) {
+    result.delta = 0;
+  }
+  return result;
+}
+
+[[nodiscard]] ImageAnalyzer::RegEffect ImageAnalyzer::offset(RegEffect x, uint16_t amount) const {
+  if (x.effect == Effect::Offset) {
+    x.delta = static_cast<uint16_t>(x.delta + amount);
+  }
+  if (x.assigned && x.assigned->tag == Value::Tag::Const) {
+    x.assigned->value = static_cast<uint16_t>(x.assigned->value + amount);
+  }
+  return x;
+}
+
+[[nodiscard]] ImageAnalyzer::RegEffect ImageAnalyzer::widen(RegEffect x) const {
+  if (x.effect == Effect::Clobbered) {
+    return x;
+  }
+  if (x.effect == Effect::Offset) {
+    x.effect = Effect::SelfRelative;
+    x.delta = 0;
+  }
+  if (x.assigned) {
+    x.assigned = as_pointer(*x.assigned);
+    if (x.assigned->tag == Value::Tag::Unknown) {
+      return {.effect = Effect::Clobbered, .delta = 0, .assigned = std::nullopt};
+    }
+  }
+  return x;
+}
+
+[[nodiscard]] ImageAnalyzer::RegEffect ImageAnalyzer::compose(const RegEffect &caller,
+                                                              const RegEffect &callee) const {
+  RegEffect result;
+  switch (callee.effect) {
+  case Effect::Clobbered:
+    return callee;
+  case Effect::Replaced:
+    return callee;
+  case Effect::Offset:
+    result = offset(caller, callee.delta);
+    break;
+  case Effect::SelfRelative:
+    result = widen(caller);
+    break;
+  }
+  if (callee.assigned) {
+    result = merge(result, {.effect = Effect::Replaced, .delta = 0, .assigned = callee.assigned});
+  }
+  return result;
+}
+
+void ImageAnalyzer::transfer(uint16_t pc, RegState &state) const {
+  const uint16_t instr = word(pc);
+  const uint16_t r0 = (instr >> 9) & 0x7;
+  const uint16_t r1 = (instr >> 6) & 0x7;
+  const Value src = state[r1];
+  const auto constant = [](uint16_t v) { return Value{.tag = Value::Tag::Const, .value = v, .address = false}; };
+
+  switch (opcode_of(instr)) {
+  case Opcode::ADD:
+    if ((instr >> 5) & 0x1) {
+      const uint16_t amount = sign_extend(instr & 0x1F, 5);
+      state[r0] = src;
+      if (src.tag == Value::Tag::Const) {
+        state[r0].value = static_cast<uint16_t>(src.value + amount);
+      }
+    } else {
+      state[r0] = sum(src, state[instr & 0x7]);
+    }
+    break;
+  case Opcode::AND:
+    if ((instr >> 5) & 0x1) {
+      const uint16_t mask = sign_extend(instr & 0x1F, 5);
+      if (mask == 0) {
+        state[r0] = constant(0);
+      } else {
+        state[r0] = src.tag == Value::Tag::Const ? constant(src.value & mask) : Value{};
+      }
+    } else {
+      const Value other = state[instr & 0x7];
+      state[r0] = src.tag == Value::Tag::Const && other.tag == Value::Tag::Const
+                      ? constant(src.value & other.value)
+                      : Value{};
+    }
+    break;
+  case Opcode::NOT:
+    state[r0] = src.tag == Value::Tag::Const ? constant(static_cast<uint16_t>(~src.value)) : Value{};
+    break;
+  case Opcode::LEA:
+    state[r0] = {.tag = Value::Tag::Const, .value = pc_offset9(pc, instr), .address = true};
+    break;
+  case Opcode::LD: {
+    // imajdaki değer, sadece hiçbir store o kelimeye yazamıyorsa. Yüklenmiş bir
+    // adresi tutuyorsa (.FILL etiket) işaretçi tabanı olabilir.
+    const uint16_t address = pc_offset9(pc, instr);
+    state[r0] = stable(address) ? Value{.tag = Value::Tag::Const,
+                                        .value = word(address),
+                                        .address = loaded[word(address)]}
+                                : Value{};
+    break;
+  }
+  case Opcode::LDI:
+  case Opcode::LDR:
+    state[r0] = {};
+    break;
+  case Opcode::JSR: {
+    // hedef(ler)in özetine göre; hedefi bilinmiyorsa her şey bozulmuş sayılıyor.
+    // Hiçbiri dönmüyorsa sonrası erişilemez, durum önemsiz.
+    const std::optional<Summary> effect = call_effect(pc);
+    if (!effect) {
+      break;
+    }
+    state[to_underlying(Register::R7)] = constant(static_cast<uint16_t>(pc + 1));
+    for (size_t r = 0; r < state.size(); ++r) {
+      const RegEffect caller =
+          state[r].tag == Value::Tag::Unknown
+              ? RegEffect{.effect = Effect::Clobbered, .delta = 0, .assigned = std::nullopt}
+              : RegEffect{.effect = Effect::Replaced, .delta = 0, .assigned = state[r]};
+      const RegEffect result = compose(caller, (*effect)[r]);
+      state[r] = result.effect == Effect::Replaced ? *result.assigned : Value{};
+    }
+    break;
+  }
+  case Opcode::TRAP: {
+    const auto vector = static_cast<Trap>(instr & 0xFF);
+    if (vector == Trap::GETC || vector == Trap::IN) {
+      state[to_underlying(Register::R0)] = {};
+    }
+    state[to_underlying(Register::R7)] = constant(static_cast<uint16_t>(pc + 1));
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+[[nodiscard]] StoreSite ImageAnalyzer::evaluate_store(uint16_t pc, const RegState &state) const {
+  const uint16_t instr = word(pc);
+  StoreSite site{.pc = pc, .target = std::nullopt, .risk = StoreRisk::Unknown};
+
+  switch (opcode_of(instr)) {
+  case Opcode::ST:
+    site.target = pc_offset9(pc, instr);
+    break;
+  case Opcode::STI: {
+    const uint16_t pointer = pc_offset9(pc, instr);
+    if (stable(pointer)) {
+      site.target = word(pointer);
+    }
+    break;
+  }
+  case Opcode::STR: {
+    const Value base = state[(instr >> 6) & 0x7];
+    if (base.tag == Value::Tag::Const) {
+      site.target = static_cast<uint16_t>(base.value + sign_extend(instr & 0x3F, 6));
+    } else if (base.tag == Value::Tag::Pointer) {
+      // pointer_into sadece yüklenmiş bölgelere işaretçi veriyor
+      site.risk = !loaded[run_start[base.value]] ? StoreRisk::Unknown
+                  : run_is_code[base.value]       ? StoreRisk::Possible
+                                                  : StoreRisk::None;
+    }
+    break;
+  }
+  default:
+    break;
+  }
+
+  if (site.target) {
+    site.risk = is_code(*site.target) ? StoreRisk::Certain : StoreRisk::None;
+  }
+  return site;
+}
+
+void ImageAnalyzer::note_store(const StoreSite &site, Value base) {
+  if (site.target) {
+    written[*site.target] = true;
+  } else if (base.tag == Value::Tag::Pointer && loaded[run_start[base.value]]) {
+    // işaretçi bölgesinde kalıyor sayılıyor, bölgenin her kelimesi yazılabilir
+    for (uint32_t a = run_start[base.value]; a < MEMORY_MAX && run_of[a] == base.value; ++a) {
+      written[a] = true;
+    }
+  } else {
+    unresolved_store = true;
+  }
+}
+
+[[nodiscard]] std::vector<uint16_t> ImageAnalyzer::propagate() {
+  std::vector<std::optional<RegState>> in(blocks.size());
+  std::vector<size_t> worklist;
+  // sadece dışarıdan verilen girişlerde yazmaçlar bilinmiyor; çağrılan
+  // fonksiyonlar çağrı noktalarındaki durumu alıyor
+  for (uint16_t entry : entries) {
+    if (block_at[entry] >= 0) {
+      in[static_cast<size_t>(block_at[entry])] = RegState{};
+      worklist.push_back(static_cast<size_t>(block_at[entry]));
+    }
+  }
+
+  auto flow = [&](uint16_t to, const RegState &state) {
+    const int successor = block_at[to];
+    if (successor < 0) {
+      return;
+    }
+    std::optional<RegState> &target = in[static_cast<size_t>(successor)];
+    bool changed = false;
+    if (!target) {
+      target = state;
+      changed = true;
+    } else {
+      for (size_t r = 0; r < state.size(); ++r) {
+        const Value merged = meet((*target)[r], state[r]);
+        if (merged != (*target)[r]) {
+          (*target)[r] = merged;
+          changed = true;
+        }
+      }
+    }
+    if (changed) {
+      worklist.push_back(static_cast<size_t>(successor));
+    }
+  };
+
+  while (!worklist.empty()) {
+    const size_t index = worklist.back();
+    worklist.pop_back();
+    RegState state = *in[index];
+    const BasicBlock &block = blocks[index];
+    for (uint32_t address = block.start; address <= block.end; ++address) {
+      const auto pc = static_cast<uint16_t>(address);
+      if (pc == block.end && opcode_of(word(pc)) == Opcode::JSR) {
+        RegState call = state;
+        call[to_underlying(Register::R7)] = {
+            .tag = Value::Tag::Const, .value = static_cast<uint16_t>(pc + 1), .address = false};
+        for (uint16_t callee : call_targets(pc)) {
+          flow(callee, call);
+        }
+      }
+      transfer(pc, state);
+    }
+
+    for (const auto &[to, kind] : block.successors) {
+      flow(to, state);
+    }
+  }
+
+  // Sabit noktadaki durumlarla store'ları ve dolaylı hedefleri değerlendir
+  stores.clear();
+  pointer_refs.clear();
+  std::erase_if(problems, [](const Problem &p) {
+    return p.kind == ProblemKind::UnresolvedJump || p.kind == ProblemKind::UnresolvedCall;
+  });
+
+  std::vector<uint16_t> discovered;
+  for (size_t index = 0; index < blocks.size(); ++index) {
+    if (!in[index]) {
+      continue;
+    }
+    RegState state = *in[index];
+    for (uint32_t address = blocks[index].start; address <= blocks[index].end; ++address) {
+      const auto pc = static_cast<uint16_t>(address);
+      const uint16_t instr = word(pc);
+      const Value base = state[(instr >> 6) & 0x7];
+
+      switch (opcode_of(instr)) {
+      case Opcode::ST:
+      case Opcode::STI:
+      case Opcode::STR:
+        stores.push_back(evaluate_store(pc, state));
+        note_store(stores.back(), opcode_of(instr) == Opcode::STR ? base : Value{});
+        [[fallthrough]];
+      case Opcode::LDR:
+        if (opcode_of(instr) != Opcode::ST && opcode_of(instr) != Opcode::STI) {
+          if (base.tag == Value::Tag::Const) {
+            pointer_refs.push_back(static_cast<uint16_t>(base.value + sign_extend(instr & 0x3F, 6)));
+          } else if (base.tag == Value::Tag::Pointer) {
+            pointer_refs.push_back(run_start[base.value]);
+          }
+        }
+        break;
+
+      case Opcode::TRAP: {
+        // PUTS/PUTSP'nin yazdırdığı dizgi de veri
+        const auto vector = static_cast<Trap>(instr & 0xFF);
+        const Value string = state[to_underlying(Register::R0)];
+        if ((vector == Trap::PUTS || vector == Trap::PUTSP) && string.tag != Value::Tag::Unknown) {
+          pointer_refs.push_back(string.tag == Value::Tag::Const ? string.value : run_start[string.value]);
+        }
+        break;
+      }
+
+      case Opcode::JMP:
+      case Opcode::JSR: {
+        const bool is_call = opcode_of(instr) == Opcode::JSR;
+        const bool indirect = is_call ? ((instr >> 11) & 0x1) == 0 : ((instr >> 6) & 0x7) != 7;
+        if (!indirect) {
+          break;
+        }
+        if (base.tag != Value::Tag::Const) {
+          problems.push_back(
+              {.pc = pc, .kind = is_call ? ProblemKind::UnresolvedCall : ProblemKind::UnresolvedJump});
+          break;
+        }
+        if (indirect_targets.emplace(pc, base.value).second) {
+          leaders[base.value] = true;
+          if (is_call) {
+            function_entries.insert(base.value);
+          }
+          discovered.push_back(base.value);
+        }
+        break;
+      }
+      default:
+        break;
+      }
+      transfer(pc, state);
+    }
+  }
+  return discovered;
+}
+
+// ============================================================================
+// Fonksiyonlar ve veri
+// ============================================================================
+
+void ImageAnalyzer::build_functions() {
+  functions.clear();
+  for (uint16_t entry : function_entries) {
+    if (block_at[entry] < 0) {
+      continue;
+    }
+    Function function{.entry = entry, .blocks = {}, .callees = {}, .unresolved_calls = 0};
+    std::set<uint16_t> seen{entry};
+    std::vector<uint16_t> worklist{entry};
+    while (!worklist.empty()) {
+      const BasicBlock &block = blocks[static_cast<size_t>(block_at[worklist.back()])];
+      worklist.pop_back();
+      function.blocks.push_back(block.start);
+
+      const uint16_t last = word(block.end);
+      if (opcode_of(last) == Opcode::JSR) {
+        if ((last >> 11) & 0x1) {
+          function.callees.insert(
+              static_cast<uint16_t>(block.end + 1 + sign_extend(last & 0x7FF, 11)));
+        } else {
+          bool resolved = false;
+          for (const auto &[pc, target] : indirect_targets) {
+            if (pc == block.end) {
+              function.callees.insert(target);
+              resolved = true;
+            }
+          }
+          function.unresolved_calls += resolved ? 0 : 1;
+        }
+      }
+
+      for (const auto &[to, kind] : block.successors) {
+        if (block_at[to] >= 0 && seen.insert(to).second) {
+          worklist.push_back(to);
+        }
+      }
+    }
+    std::sort(function.blocks.begin(), function.blocks.end());
+    functions.push_back(std::move(function));
+  }
+}
+
+[[nodiscard]] std::vector<uint16_t> ImageAnalyzer::call_targets(uint16_t pc) const {
+  const uint16_t instr = word(pc);
+  std::vector<uint16_t> targets;
+  if ((instr >> 11) & 0x1) {
+    targets.push_back(static_cast<uint16_t>(pc + 1 + sign_extend(instr & 0x7FF, 11)));
+    return targets;
+  }
+  for (auto it = indirect_targets.lower_bound({pc, 0}); it != indirect_targets.end() && it->first == pc; ++it) {
+    targets.push_back(it->second);
+  }
+  return targets;
+}
+
+[[nodiscard]] std::optional<ImageAnalyzer::Summary> ImageAnalyzer::call_effect(uint16_t pc) const {
+  const std::vector<uint16_t> targets = call_targets(pc);
+  if (targets.empty()) {
+    Summary clobbered;
+    clobbered.fill({.effect = Effect::Clobbered, .delta = 0, .assigned = std::nullopt});
+    return clobbered;
+  }
+  std::optional<Summary> effect;
+  for (uint16_t target : targets) {
+    const auto found = summaries.find(target);
+    if (found == summaries.end()) {
+      continue; // (henüz) dönmüyor
+    }
+    if (!effect) {
+      effect = found->second;
+      continue;
+    }
+    for (size_t r = 0; r < effect->size(); ++r) {
+      (*effect)[r] = merge((*effect)[r], found->second[r]);
+    }
+  }
+  return effect;
+}
+
+// Fonksiyonların yazmaç etkileri; çağrı grafiğinde sabit noktaya kadar. Hiçbir
+// fonksiyonun dönmediği varsayımıyla başlayıp özetler sadece büyüyor.
+void ImageAnalyzer::summarize() {
+  summaries.clear();
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const Function &function : functions) {
+      const std::optional<Summary> summary = function_summary(function);
+      if (!summary) {
+        continue;
+      }
+      const auto [it, inserted] = summaries.try_emplace(function.entry, *summary);
+      if (inserted || it->second != *summary) {
+        it->second = *summary;
+        changed = true;
+      }
+    }
+  }
+}
+
+[[nodiscard]] std::optional<ImageAnalyzer::Summary>
+ImageAnalyzer::function_summary(const Function &function) const {
+  std::map<uint16_t, Summary> in;
+  in[function.entry] = Summary{}; // her yazmaç giriş değerinde (Offset 0)
+  std::vector<uint16_t> worklist{function.entry};
+  std::optional<Summary> exit;
+
+  while (!worklist.empty()) {
+    const uint16_t start = worklist.back();
+    worklist.pop_back();
+    const BasicBlock &block = blocks[static_cast<size_t>(block_at[start])];
+    Summary state = in[start];
+    for (uint32_t address = block.start; address <= block.end; ++address) {
+      transfer_relative(static_cast<uint16_t>(address), state);
+    }
+
+    const uint16_t last = word(block.end);
+    if (opcode_of(last) == Opcode::JMP && ((last >> 6) & 0x7) == to_underlying(Register::R7)) {
+      if (!exit) {
+        exit = state;
+      } else {
+        for (size_t r = 0; r < state.size(); ++r) {
+          (*exit)[r] = merge((*exit)[r], state[r]);
+        }
+      }
+      continue;
+    }
+
+    for (const auto &[to, kind] : block.successors) {
+      if (block_at[to] < 0) {
+        continue;
+      }
+      const auto [it, inserted] = in.try_emplace(to, state);
+      bool grew = inserted;
+      if (!inserted) {
+        for (size_t r = 0; r < state.size(); ++r) {
+          const RegEffect merged = merge(it->second[r], state[r]);
+          if (merged != it->second[r]) {
+            it->second[r] = merged;
+            grew = true;
+          }
+        }
+      }
+      if (grew) {
+        worklist.push_back(to);
+      }
+    }
+  }
+  return exit;
+}
+
+// transfer'in fonksiyon girişine göreli hali
+void ImageAnalyzer::transfer_relative(uint16_t pc, Summary &state) const {
+  const uint16_t instr = word(pc);
+  const uint16_t r0 = (instr >> 9) & 0x7;
+  const uint16_t r1 = (instr >> 6) & 0x7;
+  const auto value_of = [](const RegEffect &x) {
+    return x.effect == Effect::Replaced ? *x.assigned : Value{};
+  };
+  const auto assign = [](Value v) {
+    return v.tag == Value::Tag::Unknown
+               ? RegEffect{.effect = Effect::Clobbered, .delta = 0, .assigned = std::nullopt}
+               : RegEffect{.effect = Effect::Replaced, .delta = 0, .assigned = v};
+  };
+
+  switch (opcode_of(instr)) {
+  case Opcode::ADD: {
+    if ((instr >> 5) & 0x1) {
+      // Rn = Rn + sabit giriş değerine göre izleniyor; başka yazmaca kopya ancak değer biliniyorsa
+      const RegEffect &src = state[r1];
+      state[r0] = r0 == r1 || src.effect == Effect::Replaced ? offset(src, sign_extend(instr & 0x1F, 5))
+                                                             : assign({});
+      break;
+    }
+    const uint16_t r2 = instr & 0x7;
+    const RegEffect a = state[r1];
+    const RegEffect b = state[r2];
+    const Value va = value_of(a);
+    const Value vb = value_of(b);
+    if (a.effect == Effect::Replaced && b.effect == Effect::Replaced) {
+      state[r0] = assign(sum(va, vb));
+    } else if (r0 == r1 && vb.tag == Value::Tag::Const) {
+      state[r0] = offset(a, vb.value);
+    } else if (r0 == r2 && va.tag == Value::Tag::Const) {
+      state[r0] = offset(b, va.value);
+    } else if (r0 == r1 || r0 == r2) {
+      state[r0] = widen(r0 == r1 ? a : b);
+    } else {
+      state[r0] = assign({});
+    }
+    break;
+  }
+  case Opcode::JSR: {
+    const std::optional<Summary> effect = call_effect(pc);
+    if (!effect) {
+      break; // dönmüyor, blokta ardıl yok
+    }
+    state[to_underlying(Register::R7)] =
+        assign({.tag = Value::Tag::Const, .value = static_cast<uint16_t>(pc + 1), .address = false});
+    for (size_t r = 0; r < state.size(); ++r) {
+      state[r] = compose(state[r], (*effect)[r]);
+    }
+    break;
+  }
+  case Opcode::AND:
+  case Opcode::NOT:
+  case Opcode::LD:
+  case Opcode::LDI:
+  case Opcode::LDR:
+  case Opcode::LEA:
+  case Opcode::TRAP: {
+    // değer hesabı transfer'deki gibi; yazılan yazmaçlar girişten kopuyor
+    RegState values;
+    for (size_t r = 0; r < state.size(); ++r) {
+      values[r] = value_of(state[r]);
+    }
+    transfer(pc, values);
+    if (opcode_of(instr) != Opcode::TRAP) {
+      state[r0] = assign(values[r0]);
+      break;
+    }
+    const auto vector = static_cast<Trap>(instr & 0xFF);
+    if (vector == Trap::GETC || vector == Trap::IN) {
+      state[to_underlying(Register::R0)] = assign({});
+    }
+    state[to_underlying(Register::R7)] = assign(values[to_underlying(Register::R7)]);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+void ImageAnalyzer::classify_data() {
+  std::vector<bool> referenced(MEMORY_MAX);
+  auto reference = [&](uint16_t address) {
+    if (loaded[address] && !is_code(address)) {
+      referenced[address] = true;
+    }
+  };
+
+  for (uint32_t address = 0; address < MEMORY_MAX; ++address) {
+    const auto pc = static_cast<uint16_t>(address);
+    if (!is_code(pc)) {
+      continue;
+    }
+    const uint16_t instr = word(pc);
+    // kod olarak çözülen bir kelime sabit gibi okunuyorsa keşif yanılmış olabilir
+    // (koda yazanlar zaten store olarak raporlanıyor)
+    if ((opcode_of(instr) == Opcode::LD || opcode_of(instr) == Opcode::LDI) &&
+        is_code(pc_offset9(pc, instr))) {
+      problems.push_back({.pc = pc, .kind = ProblemKind::CodeReadAsData});
+    }
+    switch (opcode_of(instr)) {
+    case Opcode::LD:
+    case Opcode::ST:
+    case Opcode::LEA:
+      reference(pc_offset9(pc, instr));
+      break;
+    case Opcode::LDI:
+    case Opcode::STI:
+      reference(pc_offset9(pc, instr));
+      reference(word(pc_offset9(pc, instr)));
+      break;
+    default:
+      break;
+    }
+  }
+  for (uint16_t address : pointer_refs) {
+    reference(address);
+  }
+  for (const StoreSite &store : stores) {
+    if (store.target) {
+      reference(*store.target);
+    }
+  }
+
+  // Kod dışı bir run'da ilk referanstan sonrası veri (dizgi, dizi), öncesi erişilemez
+  bool seen_reference = false;
+  for (uint32_t address = 0; address < MEMORY_MAX; ++address) {
+    const auto a = static_cast<uint16_t>(address);
+    if (!loaded[a] || is_code(a)) {
+      continue;
+    }
+    if (a == 0 || run_of[a] != run_of[a - 1]) {
+      seen_reference = false;
+    }
+    seen_reference = seen_reference || referenced[a];
+    kinds[a] = seen_reference ? WordKind::Data : WordKind::Unreachable;
+  }
+}
+
+[[nodiscard]] bool ImageAnalyzer::free_of_self_modification() const {
+  // çözülemeyen atlama/çağrıların ve yüklenmemiş belleğe düşen akışın arkasındaki
+  // kod hiç keşfedilmedi, oradaki store'lar da bilinmiyor
+  const bool unexplored = std::any_of(problems.begin(), problems.end(), [](const Problem &problem) {
+    return problem.kind == ProblemKind::UnresolvedJump || problem.kind == ProblemKind::UnresolvedCall ||
+           problem.kind == ProblemKind::ExecutesUnloaded;
+  });
+  return !unexplored && std::all_of(stores.begin(), stores.end(), [](const StoreSite &store) {
+    return store.risk == StoreRisk::None;
+  });
+}
+
+// ============================================================================
+// Çıktı
+// ============================================================================
+
+static const char *kind_name(WordKind kind) {
+  switch (kind) {
+  case WordKind::Code:
+    return "code";
+  case WordKind::Data:
+    return "data";
+  case WordKind::Unreachable:
+    return "unreachable";
+  case WordKind::Unloaded:
+  default:
+    return "unloaded";
+  }
+}
+
+static const char *edge_name(EdgeKind kind) {
+  switch (kind) {
+  case EdgeKind::Taken:
+    return "taken";
+  case EdgeKind::Jump:
+    return "jump";
+  case EdgeKind::Fallthrough:
+  default:
+    return "fallthrough";
+  }
+}
+
+static const char *risk_name(StoreRisk risk) {
+  switch (risk) {
+  case StoreRisk::None:
+    return "none";
+  case StoreRisk::Possible:
+    return "possible";
+  case StoreRisk::Certain:
+    return "certain";
+  case StoreRisk::Unknown:
+  default:
+    return "unknown";
+  }
+}
+
+static const char *problem_name(ProblemKind kind) {
+  switch (kind) {
+  case ProblemKind::InvalidOpcode:
+    return "invalid_opcode";
+  case ProblemKind::UnresolvedJump:
+    return "unresolved_jump";
+  case ProblemKind::UnresolvedCall:
+    return "unresolved_call";
+  case ProblemKind::UnknownTrap:
+    return "unknown_trap";
+  case ProblemKind::CodeReadAsData:
+    return "code_read_as_data";
+  case ProblemKind::ExecutesUnloaded:
+  default:
+    return "executes_unloaded";
+  }
+}
+
+void ImageAnalyzer::write_json(std::ostream &out) const {
+  size_t counts[4] = {};
+  for (uint32_t address = 0; address < MEMORY_MAX; ++address) {
+    ++counts[to_underlying(kinds[address])];
+  }
+  size_t risky = 0;
+  size_t unresolved = 0;
+  for (const StoreSite &store : stores) {
+    risky += store.risk == StoreRisk::Certain || store.risk == StoreRisk::Possible;
+    unresolved += store.risk == StoreRisk::Unknown;
+  }
+  const char *self_modifying = risky > 0                       ? "yes"
+                               : !free_of_self_modification() ? "unknown"
+                                                              : "no";
+
+  out << "{\n  \"entries\": [";
+  for (size_t i = 0; i < entries.size(); ++i) {
+    out << (i ? ", " : "") << quoted_hex(entries[i]);
+  }
+  out << "],\n  \"segments\": [";
+  for (size_t i = 0; i < segments.size(); ++i) {
+    out << (i ? ", " : "") << "{\"origin\": " << quoted_hex(segments[i].origin)
+        << ", \"length\": " << segments[i].length << "}";
+  }
+  out << "],\n  \"summary\": {\"code_words\": " << counts[to_underlying(WordKind::Code)]
+      << ", \"data_words\": " << counts[to_underlying(WordKind::Data)]
+      << ", \"unreachable_words\": " << counts[to_underlying(WordKind::Unreachable)]
+      << ", \"blocks\": " << blocks.size() << ", \"functions\": " << functions.size()
+      << ", \"stores\": " << stores.size() << ", \"stores_hitting_code\": " << risky
+      << ", \"stores_unresolved\": " << unresolved << ", \"problems\": " << problems.size()
+      << ", \"self_modifying\": \"" << self_modifying << "\"},\n";
+
+  out << "  \"regions\": [";
+  bool first = true;
+  for (uint32_t address = 0; address < MEMORY_MAX;) {
+    const WordKind kind = kinds[address];
+    uint32_t end = address;
+    while (end + 1 < MEMORY_MAX && kinds[end + 1] == kind) {
+      ++end;
+    }
+    if (kind != WordKind::Unloaded) {
+      out << (first ? "\n    " : ",\n    ") << "{\"start\": " << quoted_hex(static_cast<uint16_t>(address))
+          << ", \"end\": " << quoted_hex(static_cast<uint16_t>(end)) << ", \"kind\": \""
+          << kind_name(kind) << "\"}";
+      first = false;
+    }
+    address = end + 1;
+  }
+  out << "\n  ],\n";
+
+  out << "  \"functions\": [";
+  for (size_t i = 0; i < functions.size(); ++i) {
+    const Function &function = functions[i];
+    out << (i ? ",\n    " : "\n    ") << "{\"entry\": " << quoted_hex(function.entry)
+        << ", \"blocks\": [";
+    for (size_t b = 0; b < function.blocks.size(); ++b) {
+      out << (b ? ", " : "") << quoted_hex(function.blocks[b]);
+    }
+    out << "], \"calls\": [";
+    bool first_callee = true;
+    for (uint16_t callee : function.callees) {
+      out << (first_callee ? "" : ", ") << quoted_hex(callee);
+      first_callee = false;
+    }
+    out << "], \"unresolved_calls\": " << function.unresolved_calls << "}";
+  }
+  out << "\n  ],\n";
+
+  out << "  \"blocks\": [";
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    const BasicBlock &block = blocks[i];
+    out << (i ? ",\n    " : "\n    ") << "{\"start\": " << quoted_hex(block.start)
+        << ", \"end\": " << quoted_hex(block.end) << ", \"successors\": [";
+    for (size_t s = 0; s < block.successors.size(); ++s) {
+      out << (s ? ", " : "") << "{\"to\": " << quoted_hex(block.successors[s].first)
+          << ", \"kind\": \"" << edge_name(block.successors[s].second) << "\"}";
+    }
+    out << "], \"instructions\": [";
+    for (uint32_t pc = block.start; pc <= block.end; ++pc) {
+      const auto address = static_cast<uint16_t>(pc);
+      out << (pc != block.start ? ", " : "") << "{\"addr\": " << quoted_hex(address)
+          << ", \"word\": " << quoted_hex(word(address)) << ", \"asm\": \""
+          << disassemble(address, word(address)) << "\"}";
+    }
+    out << "]}";
+  }
+  out << "\n  ],\n";
+
+  out << "  \"stores\": [";
+  for (size_t i = 0; i < stores.size(); ++i) {
+    const StoreSite &store = stores[i];
+    out << (i ? ",\n    " : "\n    ") << "{\"pc\": " << quoted_hex(store.pc) << ", \"asm\": \""
+        << disassemble(store.pc, word(store.pc)) << "\", \"target\": "
+        << (store.target ? quoted_hex(*store.target) : "null") << ", \"hits_code\": \""
+        << risk_name(store.risk) << "\"}";
+  }
+  out << "\n  ],\n";
+
+  out << "  \"problems\": [";
+  for (size_t i = 0; i < problems.size(); ++i) {
+    out << (i ? ",\n    " : "\n    ") << "{\"pc\": " << quoted_hex(problems[i].pc)
+        << ", \"kind\": \"" << problem_name(problems[i].kind) << "\"}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+void ImageAnalyzer::write_dot(std::ostream &out) const {
+  // koda yazan store içeren bloklar kırmızı
+  std::set<uint16_t> risky_blocks;
+  for (const StoreSite &store : stores) {
+    if (store.risk == StoreRisk::Certain || store.risk == StoreRisk::Possible) {
+      for (const BasicBlock &block : blocks) {
+        if (store.pc >= block.start && store.pc <= block.end) {
+          risky_blocks.insert(block.start);
+        }
+      }
+    }
+  }
+
+  out << "digraph lc3 {\n  node [shape=box, fontname=\"monospace\"];\n";
+  for (const BasicBlock &block : blocks) {
+    out << "  b" << hex(block.start) << " [label=\"";
+    for (uint32_t pc = block.start; pc <= block.end; ++pc) {
+      const auto address = static_cast<uint16_t>(pc);
+      out << hex(address) << ": " << disassemble(address, word(address)) << "\\l";
+    }
+    out << "\"";
+    if (function_entries.contains(block.start)) {
+      out << ", peripheries=2";
+    }
+    if (risky_blocks.contains(block.start)) {
+      out << ", color=red";
+    }
+    out << "];\n";
+  }
+
+  for (const BasicBlock &block : blocks) {
+    for (const auto &[to, kind] : block.successors) {
+      out << "  b" << hex(block.start) << " -> b" << hex(to);
+      if (kind == EdgeKind::Fallthrough) {
+        out << " [style=dashed]";
+      } else if (kind == EdgeKind::Taken) {
+        out << " [label=\"T\"]";
+      }
+      out << ";\n";
+    }
+  }
+
+  // çağrılar
+  for (const BasicBlock &block : blocks) {
+    const uint16_t last = word(block.end);
+    if (opcode_of(last) != Opcode::JSR) {
+      continue;
+    }
+    std::vector<uint16_t> callees;
+    if ((last >> 11) & 0x1) {
+      callees.push_back(static_cast<uint16_t>(block.end + 1 + sign_extend(last & 0x7FF, 11)));
+    }
+    for (const auto &[pc, target] : indirect_targets) {
+      if (pc == block.end) {
+        callees.push_back(target);
+      }
+    }
+    for (uint16_t callee : callees) {
+      if (block_at[callee] >= 0) {
+        out << "  b" << hex(block.start) << " -> b" << hex(callee) << " [style=dotted, color=blue];\n";
+      }
+    }
+  }
+  out << "}\n";
+}
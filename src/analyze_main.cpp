@@ -0,0 +1,90 @@
+// lc3-analyze: LC-3 imajlarını çalıştırmadan CFG, erişilebilirlik ve kendini değiştiren kod raporu (analyze.h)
+
+#include "analyze.h"
+#include "vm.h"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+// "x3000", "0x3000" ya da "3000" (hep onaltılık)
+static uint16_t parse_address(std::string_view text) {
+  if (text.starts_with("0x") || text.starts_with("0X")) {
+    text.remove_prefix(2);
+  } else if (text.starts_with("x") || text.starts_with("X")) {
+    text.remove_prefix(1);
+  }
+  const unsigned long value = std::stoul(std::string(text), nullptr, 16);
+  if (value > 0xFFFF) {
+    throw std::invalid_argument("Adres 16 bit olmali: " + std::string(text));
+  }
+  return static_cast<uint16_t>(value);
+}
+
+int main(int argc, const char *argv[]) {
+  try {
+    bool dot = false;
+    bool check = false;
+    std::vector<uint16_t> entries;
+    const char *output_path = nullptr;
+
+    std::vector<const char *> args{argv[0]};
+    for (int i = 1; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      if (arg == "--dot") {
+        dot = true;
+      } else if (arg == "--json") {
+        dot = false;
+      } else if (arg == "--check") {
+        check = true;
+      } else if (arg == "--entry" && i + 1 < argc) {
+        entries.push_back(parse_address(argv[++i]));
+      } else if (arg == "-o" && i + 1 < argc) {
+        output_path = argv[++i];
+      } else {
+        args.push_back(argv[i]);
+      }
+    }
+
+    if (args.size() < 2) {
+      std::cerr << "Kullanim: lc3-analyze [--json | --dot] [--entry ADRES]... [--check] [-o DOSYA] "
+                   "image-file ...\n";
+      return 1;
+    }
+    if (entries.empty()) {
+      entries.push_back(PC_START);
+    }
+
+    // lc3 ile aynı yükleyici; imaj hiç çalıştırılmıyor
+    VirtualMachine loader;
+    if (!loader.load_images(static_cast<int>(args.size()), args.data())) {
+      return 1;
+    }
+
+    ImageAnalyzer analyzer(loader.snapshot_memory(), loader.loaded_segments());
+    analyzer.analyze(entries);
+
+    std::ofstream file;
+    if (output_path != nullptr) {
+      file.open(output_path);
+      if (!file) {
+        std::cerr << "Hata: Cikti dosyasi acilamadi: " << output_path << "\n";
+        return 1;
+      }
+    }
+    std::ostream &out = output_path != nullptr ? file : std::cout;
+    if (dot) {
+      analyzer.write_dot(out);
+    } else {
+      analyzer.write_json(out);
+    }
+
+    // --check: koda yazabilecek ya da çözülemeyen store varsa deploy öncesi başarısız
+    return check && !analyzer.free_of_self_modification() ? 2 : 0;
+  } catch (const std::exception &e) {
+    std::cerr << "Hata: " << e.what() << std::endl;
+    return 1;
+  }
+}
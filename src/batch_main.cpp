@@ -0,0 +1,136 @@
+// lc3-batch: aynı imajı birçok girdi dosyasıyla, 16'lı lockstep gruplar halinde koşturur (ensemble.h)
+
+#include "ensemble.h"
+#include "fuzz.h"
+#include "vm.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+// İmajın ilk giriş isteğine kadar çalışmasına izin verilen süre
+inline constexpr uint64_t BOOT_CYCLE_LIMIT = 500'000'000;
+
+static const char *reason_name(StopReason reason) {
+  switch (reason) {
+  case StopReason::Halt:
+    return "halt";
+  case StopReason::InvalidOpcode:
+    return "crash";
+  case StopReason::InputExhausted:
+    return "girdi-bitti";
+  case StopReason::CycleLimit:
+    return "zaman-asimi";
+  default:
+    return "?";
+  }
+}
+
+int main(int argc, const char *argv[]) {
+  try {
+    uint64_t max_steps = 10'000'000;
+    bool show_output = false;
+    bool scalar = false;
+
+    std::vector<const char *> images{argv[0]};
+    std::vector<std::string> input_files;
+    bool after_separator = false;
+    for (int i = 1; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      if (after_separator) {
+        input_files.emplace_back(arg);
+      } else if (arg == "--") {
+        after_separator = true;
+      } else if (arg == "--max-steps" && i + 1 < argc) {
+        max_steps = std::stoull(argv[++i]);
+      } else if (arg == "--show-output") {
+        show_output = true;
+      } else if (arg == "--scalar") {
+        scalar = true;
+      } else {
+        images.push_back(argv[i]);
+      }
+    }
+
+    if (images.size() < 2 || input_files.empty()) {
+      std::cerr << "Kullanim: lc3-batch [--max-steps N] [--show-output] [--scalar] image-file ... "
+                   "-- girdi-dosyasi ...\n";
+      return 1;
+    }
+
+    std::vector<FuzzInput> inputs;
+    for (const auto &path : input_files) {
+      std::ifstream file(path, std::ios::binary);
+      if (!file) {
+        std::cerr << "Hata: Girdi dosyasi acilamadi: " << path << "\n";
+        return 1;
+      }
+      inputs.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // lc3-fuzz gibi: ilk giriş isteğine kadar bir kere koşturup oradan dallanıyoruz.
+    // Program hiç girdi okumuyorsa baştan başlıyoruz.
+    VirtualMachine boot;
+    FuzzConsole silent;
+    boot.set_console(silent);
+    if (!boot.load_images(static_cast<int>(images.size()), images.data())) {
+      return 1;
+    }
+    boot.reset();
+    const Snapshot start = boot.snapshot();
+    const Snapshot at_input = boot.run_to_input(BOOT_CYCLE_LIMIT) ? boot.snapshot() : start;
+
+    using clock = std::chrono::steady_clock;
+    const auto began = clock::now();
+    uint64_t total_instructions = 0;
+    uint64_t group_steps = 0;
+    uint64_t vector_steps = 0;
+    int failures = 0;
+
+    for (size_t first = 0; first < inputs.size(); first += ENSEMBLE_LANES) {
+      Ensemble ensemble(at_input);
+      if (scalar) {
+        ensemble.force_scalar();
+      }
+      for (int lane = 0; lane < ENSEMBLE_LANES; ++lane) {
+        if (first + lane < inputs.size()) {
+          ensemble.set_input(lane, inputs[first + lane]);
+        } else {
+          ensemble.disable(lane);
+        }
+      }
+      ensemble.run(max_steps);
+      group_steps += ensemble.group_steps();
+      vector_steps += ensemble.vector_steps();
+
+      for (int lane = 0; lane < ENSEMBLE_LANES && first + lane < inputs.size(); ++lane) {
+        const StopReason reason = ensemble.stopped_by(lane);
+        total_instructions += ensemble.instructions(lane);
+        failures += reason == StopReason::InvalidOpcode || reason == StopReason::CycleLimit;
+        std::cout << input_files[first + lane] << ": " << reason_name(reason)
+                  << ", komut: " << ensemble.instructions(lane) << "\n";
+        if (show_output) {
+          std::cout << ensemble.output(lane) << "\n";
+        }
+      }
+    }
+
+    const std::chrono::duration<double> elapsed = clock::now() - began;
+    std::cerr << "Girdi: " << inputs.size() << ", lane-komut: " << total_instructions << ", "
+              << std::fixed << std::setprecision(1)
+              << static_cast<double>(total_instructions) / elapsed.count() / 1e6 << " M/s"
+              << ", grup adimi: " << group_steps << " (vektor: " << vector_steps << ", "
+              << (Ensemble::simd_available() && !scalar ? "AVX2" : "skaler") << ")"
+              << ", ortalama lane: "
+              << (group_steps ? static_cast<double>(total_instructions) / group_steps : 0.0) << "\n";
+    return failures > 0 ? 1 : 0;
+  } catch (const std::exception &e) {
+    std::cerr << "Hata: " << e.what() << std::endl;
+    return 1;
+  }
+}
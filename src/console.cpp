@@ -0,0 +1,82 @@
+#include "console.h"
+
+#include <iostream>
+
+#include <sys/select.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+void Console::fault(std::string_view message) { std::cerr << message << std::endl; }
+
+// ============================================================================
+// Terminal
+// ============================================================================
+
+[[nodiscard]] bool TerminalConsole::key_ready() {
+  // klavye okumasına bakılıyor [[nodiscard]] ile bunun kontrol edilip
+  // edilmediğini kontrol ediyoruz.
+  fd_set readfds;
+  FD_ZERO(&readfds);
+  FD_SET(STDIN_FILENO, &readfds);
+
+  struct timeval timeout{.tv_sec = 0, .tv_usec = 0};
+
+  // POLLING-> herhangi bir bekleme yapılmıyor anlık olarak kontrol ediliyor.
+  // LC-3'te bu kullanılıyor.
+  /*
+  Interrupt-Driven vs Polling
+  Continuing with the above keyboard example, the question is how does the
+  microprocessor know when the ready bit has been set? One way is by polling
+  where the microprocessor is continuously checking to see if the ready bit has
+  been set or not. If it is set then it will go and read in the key. This method
+  does not require any extra hardware support but waste a lot of CPU time for
+  the microprocessor to continually check the ready bit. A more efficient
+  method, but requires extra hardware support, is to use an interrupt. The
+  microprocessor is doing its own thing until it is interrupted by the keyboard,
+  at which time it will then go and read in the key. The LC3 uses the polling
+  method.
+  https://hwang.lasierra.edu/~enoch/CPTG%20245/LC-3/LC-3%20InputOutput.pdf
+  */
+
+  /*
+  extern int select (int __nfds, fd_set *__restrict __readfds,
+  fd_set *__restrict __writefds,
+  fd_set *__restrict __exceptfds,
+  struct timeval *__restrict __timeout);
+
+  Dosya ID'leri:  0   1   2   3   4   5  ...  1023   FD'lerin gösterimi
+  Bits:         [ 1 | 0 | 0 | 0 | 0 | 0 | ... | 0 ]
+                  ^
+             (Bizim Klavye - STDIN)
+  */
+
+  return select(1, // kaç tane fd'ye bakmak istiyorsak gibi düşünebiliriz.
+                &readfds, // klavyeden veri gelip gelmediğine bakılıyor.
+                nullptr, // yazma listesi ile ilgili bir şeyi kontrol etmiyoruz.
+                nullptr, // hata listesini de kontrol etmiyoruz.
+                &timeout // bekleme süresini ayarladığımız gibi veriyoruz.
+                ) > 0;   // 0 dan büyükse veri var demektir.
+}
+
+// key_ready ile aynı select, sadece sıfır yerine verilen süre kadar bekliyor
+[[nodiscard]] bool TerminalConsole::wait_ready(std::chrono::milliseconds timeout) {
+  fd_set readfds;
+  FD_ZERO(&readfds);
+  FD_SET(STDIN_FILENO, &readfds);
+
+  const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(timeout).count();
+  struct timeval tv{.tv_sec = static_cast<time_t>(micros / 1000000),
+                    .tv_usec = static_cast<suseconds_t>(micros % 1000000)};
+  return select(1, &readfds, nullptr, nullptr, &tv) > 0;
+}
+
+[[nodiscard]] int TerminalConsole::get() { return std::cin.get(); }
+
+void TerminalConsole::put(char c) { std::cout.put(c); }
+
+void TerminalConsole::flush() { std::cout.flush(); }
+
+[[nodiscard]] TerminalConsole &TerminalConsole::instance() {
+  static TerminalConsole console;
+  return console;
+}
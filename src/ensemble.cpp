@@ -0,0 +1,526 @@
+#include "ensemble.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LC3_X86 1
+// Dosyanın geri kalanı AVX2'siz derleniyor, AVX2 sadece bu fonksiyonlarda ve
+// simd_available() true ise çağrılıyor.
+#define LC3_AVX2 __attribute__((target("avx2")))
+#endif
+
+Ensemble::Ensemble(const Snapshot &start)
+    : memory(static_cast<size_t>(ENSEMBLE_LANES) * MEMORY_MAX + 2) {
+  for (int lane = 0; lane < ENSEMBLE_LANES; ++lane) {
+    std::copy(start.memory->begin(), start.memory->end(), &cell(lane, 0));
+    for (size_t r = 0; r < reg.size(); ++r) {
+      reg[r][lane] = start.reg[r];
+    }
+  }
+  reasons.fill(StopReason::None);
+  active = (1u << ENSEMBLE_LANES) - 1;
+  use_simd = simd_available();
+}
+
+[[nodiscard]] bool Ensemble::simd_available() {
+#ifdef LC3_X86
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+void Ensemble::set_input(int lane, std::span<const uint8_t> data) {
+  inputs[lane].assign(data.begin(), data.end());
+  input_positions[lane] = 0;
+}
+
+void Ensemble::disable(int lane) { active &= ~(1u << lane); }
+
+void Ensemble::stop(int lane, StopReason reason) {
+  reasons[lane] = reason;
+  active &= ~(1u << lane);
+}
+
+void Ensemble::run(uint64_t max_steps) {
+  const uint64_t limit = steps + max_steps;
+  while (active != 0 && steps < limit) {
+    ++steps;
+    if (use_simd) {
+      step_simd();
+    } else {
+      step_scalar();
+    }
+  }
+
+  for (int lane = 0; lane < ENSEMBLE_LANES; ++lane) {
+    if (active & (1u << lane)) {
+      stop(lane, StopReason::CycleLimit);
+    }
+  }
+}
+
+// ============================================================================
+// Scalar lane (VirtualMachine ile aynı semantik)
+// ============================================================================
+
+[[nodiscard]] uint16_t Ensemble::read(int lane, uint16_t address) {
+  if (address == to_underlying(MemoryMappedRegister::KBSR)) {
+    std::vector<uint8_t> &input = inputs[lane];
+    size_t &position = input_positions[lane];
+    if (position < input.size()) {
+      cell(lane, to_underlying(MemoryMappedRegister::KBSR)) = (1 << 15);
+      cell(lane, to_underlying(MemoryMappedRegister::KBDR)) = input[position++];
+    } else {
+      stop(lane, StopReason::InputExhausted);
+      cell(lane, to_underlying(MemoryMappedRegister::KBSR)) = 0;
+    }
+  }
+  return cell(lane, address);
+}
+
+void Ensemble::update_flags(int lane, uint16_t r) {
+  uint16_t &cond = lane_reg(Register::COND, lane);
+  if (reg[r][lane] == 0) {
+    cond = to_underlying(ConditionFlag::ZRO);
+  } else if (reg[r][lane] >> 15) {
+    cond = to_underlying(ConditionFlag::NEG);
+  } else {
+    cond = to_underlying(ConditionFlag::POS);
+  }
+}
+
+void Ensemble::step_lane(int lane) {
+  uint16_t &pc = lane_reg(Register::PC, lane);
+  const uint16_t instr = read(lane, pc++);
+  execute_lane(lane, instr);
+}
+
+void Ensemble::execute_lane(int lane, uint16_t instr) {
+  const uint16_t r0 = (instr >> 9) & 0x7;
+  const uint16_t r1 = (instr >> 6) & 0x7;
+  uint16_t &pc = lane_reg(Register::PC, lane);
+  ++retired[lane];
+
+  switch (static_cast<Opcode>(instr >> 12)) {
+  case Opcode::ADD:
+  case Opcode::AND: {
+    const uint16_t operand = ((instr >> 5) & 0x1) ? sign_extend(instr & 0x1F, 5) : reg[instr & 0x7][lane];
+    reg[r0][lane] = (instr >> 12) == to_underlying(Opcode::ADD)
+                        ? static_cast<uint16_t>(reg[r1][lane] + operand)
+                        : static_cast<uint16_t>(reg[r1][lane] & operand);
+    update_flags(lane, r0);
+    break;
+  }
+  case Opcode::NOT:
+    reg[r0][lane] = static_cast<uint16_t>(~reg[r1][lane]);
+    update_flags(lane, r0);
+    break;
+  case Opcode::BR:
+    if (((instr >> 9) & 0x7) & lane_reg(Register::COND, lane)) {
+      pc += sign_extend(instr & 0x1FF, 9);
+    }
+    break;
+  case Opcode::JMP:
+    pc = reg[r1][lane];
+    break;
+  case Opcode::JSR:
+    // VM'deki gibi önce R7 yazılıyor, JSRR R7 bu yüzden PC'ye atlar
+    lane_reg(Register::R7, lane) = pc;
+    if ((instr >> 11) & 0x1) {
+      pc += sign_extend(instr & 0x7FF, 11);
+    } else {
+      pc = reg[r1][lane];
+    }
+    break;
+  case Opcode::LD:
+    reg[r0][lane] = read(lane, pc + sign_extend(instr & 0x1FF, 9));
+    update_flags(lane, r0);
+    break;
+  case Opcode::LDI:
+    reg[r0][lane] = read(lane, read(lane, pc + sign_extend(instr & 0x1FF, 9)));
+    update_flags(lane, r0);
+    break;
+  case Opcode::LDR:
+    reg[r0][lane] = read(lane, reg[r1][lane] + sign_extend(instr & 0x3F, 6));
+    update_flags(lane, r0);
+    break;
+  case Opcode::LEA:
+    reg[r0][lane] = pc + sign_extend(instr & 0x1FF, 9);
+    update_flags(lane, r0);
+    break;
+  case Opcode::ST:
+    cell(lane, pc + sign_extend(instr & 0x1FF, 9)) = reg[r0][lane];
+    break;
+  case Opcode::STI:
+    cell(lane, read(lane, pc + sign_extend(instr & 0x1FF, 9))) = reg[r0][lane];
+    break;
+  case Opcode::STR:
+    cell(lane, reg[r1][lane] + sign_extend(instr & 0x3F, 6)) = reg[r0][lane];
+    break;
+  case Opcode::TRAP:
+    trap_lane(lane, instr);
+    break;
+  case Opcode::RES:
+  case Opcode::RTI:
+  default:
+    stop(lane, StopReason::InvalidOpcode);
+    break;
+  }
+}
+
+void Ensemble::trap_lane(int lane, uint16_t instr) {
+  lane_reg(Register::R7, lane) = lane_reg(Register::PC, lane);
+  uint16_t &r0 = lane_reg(Register::R0, lane);
+  std::string &out = outputs[lane];
+  const std::vector<uint8_t> &input = inputs[lane];
+  size_t &position = input_positions[lane];
+
+  switch (static_cast<Trap>(instr & 0xFF)) {
+  case Trap::GETC:
+    if (position >= input.size()) {
+      stop(lane, StopReason::InputExhausted);
+      break;
+    }
+    r0 = input[position++];
+    update_flags(lane, to_underlying(Register::R0));
+    break;
+  case Trap::OUT:
+    out.push_back(static_cast<char>(r0));
+    break;
+  case Trap::PUTS:
+    for (uint16_t addr = r0; cell(lane, addr) != 0; ++addr) {
+      out.push_back(static_cast<char>(cell(lane, addr)));
+    }
+    break;
+  case Trap::IN: {
+    if (position >= input.size()) {
+      stop(lane, StopReason::InputExhausted);
+      break;
+    }
+    out += "Karakter girin: ";
+    const char c = static_cast<char>(input[position++]);
+    out.push_back(c);
+    r0 = static_cast<uint16_t>(c);
+    update_flags(lane, to_underlying(Register::R0));
+    break;
+  }
+  case Trap::PUTSP:
+    for (uint16_t addr = r0; cell(lane, addr) != 0; ++addr) {
+      const uint16_t two_chars = cell(lane, addr);
+      out.push_back(static_cast<char>(two_chars & 0xFF));
+      if (two_chars >> 8) {
+        out.push_back(static_cast<char>(two_chars >> 8));
+      }
+    }
+    break;
+  case Trap::HALT:
+    stop(lane, StopReason::Halt);
+    break;
+  default:
+    break;
+  }
+}
+
+// En az komut çalıştırmış aktif lane. Düşük adreste sonsuz döngüde kalan bir lane
+// min-PC yüzünden diğerlerini hiç çalıştırmasın diye arada bir onun PC'sine geçiyoruz.
+[[nodiscard]] int Ensemble::starved_lane() const {
+  int starved = std::countr_zero(active);
+  for (uint32_t rest = active; rest != 0; rest &= rest - 1) {
+    const int lane = std::countr_zero(rest);
+    if (retired[lane] < retired[starved]) {
+      starved = lane;
+    }
+  }
+  return starved;
+}
+
+void Ensemble::step_scalar() {
+  uint16_t group_pc = 0xFFFF;
+  if (steps % FAIRNESS_PERIOD == 0) {
+    group_pc = lane_reg(Register::PC, starved_lane());
+  } else {
+    for (int lane = 0; lane < ENSEMBLE_LANES; ++lane) {
+      if (active & (1u << lane)) {
+        group_pc = std::min(group_pc, lane_reg(Register::PC, lane));
+      }
+    }
+  }
+  const uint32_t mask = active;
+  for (int lane = 0; lane < ENSEMBLE_LANES; ++lane) {
+    if ((mask & (1u << lane)) && lane_reg(Register::PC, lane) == group_pc) {
+      step_lane(lane);
+    }
+  }
+}
+
+// ============================================================================
+// AVX2 group step
+// ============================================================================
+
+#ifdef LC3_X86
+
+// lane bit maskesi -> lane başına 0xFFFF / 0x0000
+LC3_AVX2 static inline __m256i expand_mask(uint32_t mask) {
+  const __m256i bits = _mm256_setr_epi16(0x1, 0x2, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80, 0x100, 0x200,
+                                         0x400, 0x800, 0x1000, 0x2000, 0x4000,
+                                         static_cast<short>(0x8000));
+  const __m256i broadcast = _mm256_set1_epi16(static_cast<short>(mask));
+  return _mm256_cmpeq_epi16(_mm256_and_si256(broadcast, bits), bits);
+}
+
+LC3_AVX2 static inline uint32_t compress_mask(__m256i lanes) {
+  const __m128i packed =
+      _mm_packs_epi16(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+  return static_cast<uint32_t>(_mm_movemask_epi8(packed));
+}
+
+// maskelenen lane'lerden biri >= MMIO_BEGIN mi
+LC3_AVX2 static inline bool touches_mmio(__m256i addresses, __m256i m) {
+  const __m256i limit = _mm256_set1_epi16(static_cast<short>(MMIO_BEGIN));
+  const __m256i high = _mm256_cmpeq_epi16(_mm256_max_epu16(addresses, limit), addresses);
+  return !_mm256_testz_si256(high, m);
+}
+
+// lane i için memory[i * MEMORY_MAX + addresses[i]]. AVX2'de 16 bit gather yok, 32 bit
+// gather edip alt yarıyı alıyoruz (little endian).
+LC3_AVX2 static inline __m256i gather16(const uint16_t *memory, __m256i addresses) {
+  const __m256i lane_base_lo = _mm256_setr_epi32(0 * MEMORY_MAX, 1 * MEMORY_MAX, 2 * MEMORY_MAX,
+                                                 3 * MEMORY_MAX, 4 * MEMORY_MAX, 5 * MEMORY_MAX,
+                                                 6 * MEMORY_MAX, 7 * MEMORY_MAX);
+  const __m256i lane_base_hi = _mm256_add_epi32(lane_base_lo, _mm256_set1_epi32(8 * MEMORY_MAX));
+  const __m256i low16 = _mm256_set1_epi32(0xFFFF);
+  const int *base = reinterpret_cast<const int *>(memory);
+
+  const __m256i index_lo =
+      _mm256_add_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(addresses)), lane_base_lo);
+  const __m256i index_hi =
+      _mm256_add_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(addresses, 1)), lane_base_hi);
+  const __m256i words_lo = _mm256_and_si256(_mm256_i32gather_epi32(base, index_lo, 2), low16);
+  const __m256i words_hi = _mm256_and_si256(_mm256_i32gather_epi32(base, index_hi, 2), low16);
+
+  // packus 128 bitlik yarılar içinde paketliyor, sırayı permute ile düzeltiyoruz
+  return _mm256_permute4x64_epi64(_mm256_packus_epi32(words_lo, words_hi), 0xD8);
+}
+
+LC3_AVX2 static inline __m256i load_row(const std::array<uint16_t, ENSEMBLE_LANES> &row) {
+  return _mm256_load_si256(reinterpret_cast<const __m256i *>(row.data()));
+}
+
+LC3_AVX2 static inline void store_row(std::array<uint16_t, ENSEMBLE_LANES> &row, __m256i val,
+                                      __m256i m) {
+  const __m256i old = load_row(row);
+  _mm256_store_si256(reinterpret_cast<__m256i *>(row.data()), _mm256_blendv_epi8(old, val, m));
+}
+
+LC3_AVX2 static inline __m256i condition_of(__m256i val) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i cond = _mm256_set1_epi16(to_underlying(ConditionFlag::POS));
+  cond = _mm256_blendv_epi8(cond, _mm256_set1_epi16(to_underlying(ConditionFlag::NEG)),
+                            _mm256_cmpgt_epi16(zero, val));
+  return _mm256_blendv_epi8(cond, _mm256_set1_epi16(to_underlying(ConditionFlag::ZRO)),
+                            _mm256_cmpeq_epi16(val, zero));
+}
+
+// DR ve bayraklar birlikte yazılıyor
+LC3_AVX2 static inline void write_result(std::array<uint16_t, ENSEMBLE_LANES> &dst,
+                                         std::array<uint16_t, ENSEMBLE_LANES> &cond, __m256i m,
+                                         __m256i val) {
+  store_row(dst, val, m);
+  store_row(cond, condition_of(val), m);
+}
+
+LC3_AVX2 void Ensemble::step_simd() {
+  // min-PC: çalışmayan lane'ler 0xFFFF sayılıyor
+  const __m256i pcs = load_row(reg[to_underlying(Register::PC)]);
+  const __m256i running = expand_mask(active);
+  const __m256i candidates = _mm256_or_si256(pcs, _mm256_andnot_si256(running, _mm256_set1_epi16(-1)));
+  const __m128i halves = _mm_min_epu16(_mm256_castsi256_si128(candidates),
+                                       _mm256_extracti128_si256(candidates, 1));
+  auto group_pc = static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(halves)));
+  int leader = -1;
+  if (steps % FAIRNESS_PERIOD == 0) {
+    leader = starved_lane();
+    group_pc = lane_reg(Register::PC, leader);
+  }
+
+  const __m256i at_pc = _mm256_and_si256(
+      _mm256_cmpeq_epi16(pcs, _mm256_set1_epi16(static_cast<short>(group_pc))), running);
+  uint32_t mask = compress_mask(at_pc);
+
+  if (group_pc >= MMIO_BEGIN) {
+    // cihaz yazmaçlarından komut okumak: VM'deki gibi mem_read yolundan
+    for (uint32_t rest = mask; rest != 0; rest &= rest - 1) {
+      step_lane(std::countr_zero(rest));
+    }
+    return;
+  }
+
+  // Aynı PC'de farklı komut (kendini değiştiren kod) olan lane'ler bu adımda bekliyor;
+  // lider kalkınca bir sonraki adımda kendi aralarında gruplanıyorlar.
+  if (leader < 0) {
+    leader = std::countr_zero(mask);
+  }
+  const uint16_t instr = cell(leader, group_pc);
+  const __m256i fetched = gather16(memory.data(), _mm256_set1_epi16(static_cast<short>(group_pc)));
+  mask &= compress_mask(_mm256_cmpeq_epi16(fetched, _mm256_set1_epi16(static_cast<short>(instr))));
+
+  const auto next_pc = static_cast<uint16_t>(group_pc + 1);
+  if (execute_group_simd(mask, instr, next_pc)) {
+    ++simd_steps;
+    return;
+  }
+
+  for (uint32_t rest = mask; rest != 0; rest &= rest - 1) {
+    const int lane = std::countr_zero(rest);
+    lane_reg(Register::PC, lane) = next_pc;
+    execute_lane(lane, instr);
+  }
+}
+
+LC3_AVX2 bool Ensemble::execute_group_simd(uint32_t mask, uint16_t instr, uint16_t next_pc) {
+  const __m256i m = expand_mask(mask);
+  const uint16_t r0 = (instr >> 9) & 0x7;
+  const uint16_t r1 = (instr >> 6) & 0x7;
+  auto &rows = reg;
+  auto &pc_row = rows[to_underlying(Register::PC)];
+  auto &cond_row = rows[to_underlying(Register::COND)];
+
+  // Önce fallback gerekip gerekmediğine karar veriyoruz, durum ancak ondan sonra değişiyor.
+  __m256i loaded{};
+  switch (static_cast<Opcode>(instr >> 12)) {
+  case Opcode::LD: {
+    const auto address = static_cast<uint16_t>(next_pc + sign_extend(instr & 0x1FF, 9));
+    if (address >= MMIO_BEGIN) {
+      return false;
+    }
+    loaded = gather16(memory.data(), _mm256_set1_epi16(static_cast<short>(address)));
+    break;
+  }
+  case Opcode::LDR: {
+    const __m256i addresses = _mm256_add_epi16(
+        load_row(rows[r1]), _mm256_set1_epi16(static_cast<short>(sign_extend(instr & 0x3F, 6))));
+    if (touches_mmio(addresses, m)) {
+      return false;
+    }
+    loaded = gather16(memory.data(), addresses);
+    break;
+  }
+  case Opcode::LDI:
+  case Opcode::STI: {
+    const auto pointer = static_cast<uint16_t>(next_pc + sign_extend(instr & 0x1FF, 9));
+    if (pointer >= MMIO_BEGIN) {
+      return false;
+    }
+    loaded = gather16(memory.data(), _mm256_set1_epi16(static_cast<short>(pointer)));
+    if ((instr >> 12) == to_underlying(Opcode::LDI)) {
+      if (touches_mmio(loaded, m)) {
+        return false;
+      }
+      loaded = gather16(memory.data(), loaded);
+    }
+    break;
+  }
+  case Opcode::TRAP:
+  case Opcode::RTI:
+  case Opcode::RES:
+    return false;
+  default:
+    break;
+  }
+
+  store_row(pc_row, _mm256_set1_epi16(static_cast<short>(next_pc)), m);
+
+  switch (static_cast<Opcode>(instr >> 12)) {
+  case Opcode::ADD:
+  case Opcode::AND: {
+    const __m256i operand =
+        ((instr >> 5) & 0x1)
+            ? _mm256_set1_epi16(static_cast<short>(sign_extend(instr & 0x1F, 5)))
+            : load_row(rows[instr & 0x7]);
+    const __m256i lhs = load_row(rows[r1]);
+    write_result(rows[r0], cond_row, m, (instr >> 12) == to_underlying(Opcode::ADD) ? _mm256_add_epi16(lhs, operand)
+                                                             : _mm256_and_si256(lhs, operand));
+    break;
+  }
+  case Opcode::NOT:
+    write_result(rows[r0], cond_row, m, _mm256_xor_si256(load_row(rows[r1]), _mm256_set1_epi16(-1)));
+    break;
+  case Opcode::LEA:
+    write_result(rows[r0], cond_row, m, _mm256_set1_epi16(static_cast<short>(next_pc + sign_extend(instr & 0x1FF, 9))));
+    break;
+  case Opcode::LD:
+  case Opcode::LDR:
+  case Opcode::LDI:
+    write_result(rows[r0], cond_row, m, loaded);
+    break;
+
+  case Opcode::BR: {
+    const __m256i nzp = _mm256_set1_epi16(static_cast<short>((instr >> 9) & 0x7));
+    const __m256i not_taken =
+        _mm256_cmpeq_epi16(_mm256_and_si256(load_row(cond_row), nzp), _mm256_setzero_si256());
+    const __m256i target =
+        _mm256_set1_epi16(static_cast<short>(next_pc + sign_extend(instr & 0x1FF, 9)));
+    store_row(pc_row, target, _mm256_andnot_si256(not_taken, m));
+    break;
+  }
+  case Opcode::JMP:
+    store_row(pc_row, load_row(rows[r1]), m);
+    break;
+  case Opcode::JSR:
+    store_row(rows[to_underlying(Register::R7)], _mm256_set1_epi16(static_cast<short>(next_pc)), m);
+    if ((instr >> 11) & 0x1) {
+      store_row(pc_row,
+                _mm256_set1_epi16(static_cast<short>(next_pc + sign_extend(instr & 0x7FF, 11))), m);
+    } else {
+      store_row(pc_row, load_row(rows[r1]), m);
+    }
+    break;
+
+  // AVX2'de scatter yok: adresleri vektörde hesaplayıp lane lane yazıyoruz
+  case Opcode::ST:
+  case Opcode::STR:
+  case Opcode::STI: {
+    alignas(32) std::array<uint16_t, ENSEMBLE_LANES> addresses;
+    if ((instr >> 12) == to_underlying(Opcode::STR)) {
+      _mm256_store_si256(reinterpret_cast<__m256i *>(addresses.data()),
+                         _mm256_add_epi16(load_row(rows[r1]), _mm256_set1_epi16(static_cast<short>(
+                                                                  sign_extend(instr & 0x3F, 6)))));
+    } else if ((instr >> 12) == to_underlying(Opcode::STI)) {
+      _mm256_store_si256(reinterpret_cast<__m256i *>(addresses.data()), loaded);
+    } else {
+      addresses.fill(static_cast<uint16_t>(next_pc + sign_extend(instr & 0x1FF, 9)));
+    }
+    for (uint32_t rest = mask; rest != 0; rest &= rest - 1) {
+      const int lane = std::countr_zero(rest);
+      cell(lane, addresses[lane]) = rows[r0][lane];
+    }
+    break;
+  }
+  default:
+    break;
+  }
+
+  // retired[lane] += 1 maskelenen lane'ler için (0xFFFF = -1, işaretli genişletip çıkarıyoruz)
+  // 64 bit sayaçlar: 4'er lane'lik dört parça
+  auto *counts = reinterpret_cast<__m256i *>(retired.data());
+  const __m128i low = _mm256_castsi256_si128(m);
+  const __m128i high = _mm256_extracti128_si256(m, 1);
+  for (int quarter = 0; quarter < 4; ++quarter) {
+    const __m128i half = quarter < 2 ? low : high;
+    const __m128i lanes = quarter % 2 == 0 ? half : _mm_srli_si128(half, 8);
+    _mm256_store_si256(counts + quarter, _mm256_sub_epi64(_mm256_load_si256(counts + quarter),
+                                                          _mm256_cvtepi16_epi64(lanes)));
+  }
+  return true;
+}
+
+#else
+
+void Ensemble::step_simd() { step_scalar(); }
+
+bool Ensemble::execute_group_simd(uint32_t, uint16_t, uint16_t) { return false; }
+
+#endif
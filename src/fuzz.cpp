@@ -0,0 +1,262 @@
+#include "fuzz.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+// Oyunlar genelde bunlara tepki veriyor, rastgele bayt yerine arada bir bunları deniyoruz.
+inline constexpr std::array<uint8_t, 16> INTERESTING_KEYS = {
+    'w', 'a', 's', 'd', 'W', 'A', 'S', 'D', 'y', 'n', 'q', ' ', '\n', '\r', 0x1B, 0x00};
+
+// Hit sayısını AFL'deki gibi kovalara ayırıyoruz; döngünün 3 yerine 4 kere dönmesi
+// yeni kapsam sayılmasın ama 4 yerine 40 kere dönmesi sayılsın.
+static uint8_t bucket(uint8_t hits) {
+  if (hits <= 2) return hits;
+  if (hits == 3) return 4;
+  if (hits < 8) return 8;
+  if (hits < 16) return 16;
+  if (hits < 32) return 32;
+  if (hits < 128) return 64;
+  return 128;
+}
+
+static void mutate(FuzzInput &data, const std::vector<FuzzInput> &pool, std::mt19937_64 &rng,
+                   size_t max_len) {
+  auto pick = [&rng](size_t n) { return static_cast<size_t>(rng() % n); };
+  auto random_byte = [&] {
+    return pick(2) == 0 ? INTERESTING_KEYS[pick(INTERESTING_KEYS.size())]
+                        : static_cast<uint8_t>(rng());
+  };
+
+  const size_t rounds = 1 + pick(4);
+  for (size_t round = 0; round < rounds; ++round) {
+    switch (data.empty() ? 0 : pick(6)) {
+    case 0: // bayt ekle
+      if (data.size() < max_len) {
+        data.insert(data.begin() + static_cast<std::ptrdiff_t>(pick(data.size() + 1)), random_byte());
+      }
+      break;
+    case 1: // bayt değiştir
+      data[pick(data.size())] = random_byte();
+      break;
+    case 2: // bit çevir
+      data[pick(data.size())] ^= static_cast<uint8_t>(1 << pick(8));
+      break;
+    case 3: // bayt sil
+      data.erase(data.begin() + static_cast<std::ptrdiff_t>(pick(data.size())));
+      break;
+    case 4: { // bir parçayı tekrarla (aynı tuşa art arda basmak)
+      const size_t from = pick(data.size());
+      const size_t len = std::min(1 + pick(8), data.size() - from);
+      const FuzzInput chunk(data.begin() + static_cast<std::ptrdiff_t>(from),
+                            data.begin() + static_cast<std::ptrdiff_t>(from + len));
+      data.insert(data.begin() + static_cast<std::ptrdiff_t>(pick(data.size() + 1)), chunk.begin(),
+                  chunk.end());
+      break;
+    }
+    case 5: { // başka bir korpus girdisiyle birleştir
+      const FuzzInput &other = pool[pick(pool.size())];
+      const size_t cut = pick(data.size() + 1);
+      data.resize(cut);
+      if (!other.empty()) {
+        const size_t from = pick(other.size());
+        data.insert(data.end(), other.begin() + static_cast<std::ptrdiff_t>(from), other.end());
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  if (data.size() > max_len) {
+    data.resize(max_len);
+  }
+}
+
+Fuzzer::Fuzzer(Snapshot snapshot, FuzzConfig config)
+    : snapshot(std::move(snapshot)), config(std::move(config)),
+      virgin(std::make_unique<std::atomic<uint8_t>[]>(COVERAGE_MAP_SIZE)) {
+  corpus = this->config.seeds;
+  if (corpus.empty()) {
+    corpus.emplace_back();
+  }
+  this->config.workers = std::max(this->config.workers, 1u);
+}
+
+// Trace'teki kovalar global haritada yoksa ekler. Worker'lar aynı anda çağırabilir.
+[[nodiscard]] bool Fuzzer::merge_coverage(const uint8_t *trace) {
+  bool novel = false;
+  for (size_t i = 0; i < COVERAGE_MAP_SIZE; i += sizeof(uint64_t)) {
+    // harita çoğunlukla boş, 8 baytlık parçalar halinde atlıyoruz
+    uint64_t chunk;
+    std::memcpy(&chunk, trace + i, sizeof(chunk));
+    if (chunk == 0) {
+      continue;
+    }
+
+    for (size_t j = i; j < i + sizeof(uint64_t); ++j) {
+      if (trace[j] == 0) {
+        continue;
+      }
+      const uint8_t seen = bucket(trace[j]);
+      if ((seen & ~virgin[j].load(std::memory_order_relaxed)) == 0) {
+        continue;
+      }
+      const uint8_t old = virgin[j].fetch_or(seen, std::memory_order_relaxed);
+      if (seen & ~old) {
+        novel = true;
+        if (old == 0) {
+          edges.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+  return novel;
+}
+
+void Fuzzer::save(const char *kind, uint64_t id, const FuzzInput &input) const {
+  if (config.output_dir.empty()) {
+    return;
+  }
+  std::ostringstream name;
+  name << kind << "-" << std::setw(6) << std::setfill('0') << id;
+  std::ofstream file(config.output_dir / kind / name.str(), std::ios::binary);
+  file.write(reinterpret_cast<const char *>(input.data()), static_cast<std::streamsize>(input.size()));
+}
+
+void Fuzzer::worker(std::stop_token stop, unsigned id) {
+  // her worker'ın kendi VM'i var, hepsi aynı snapshot sayfalarını paylaşıyor
+  VirtualMachine vm(snapshot.memory);
+  FuzzConsole console;
+  vm.set_console(console);
+  std::vector<uint8_t> trace(COVERAGE_MAP_SIZE);
+  vm.set_coverage(trace.data());
+  vm.set_cycle_limit(snapshot.cycle_count + config.max_cycles);
+
+  std::mt19937_64 rng(config.seed + id);
+  std::vector<FuzzInput> pool;
+  size_t synced = 0;
+  uint64_t pending_execs = 0;
+  FuzzInput input;
+
+  // execs sayacını her testte değil, parça parça güncelliyoruz (thread'ler arası cache trafiği).
+  // Crash/hang sayılmadan önce bekleyen execs yazılıyor, durum satırında hang > exec görünmesin.
+  constexpr uint64_t EXEC_BATCH = 64;
+  auto flush_execs = [&] {
+    execs.fetch_add(pending_execs, std::memory_order_relaxed);
+    pending_execs = 0;
+  };
+
+  for (uint64_t local = 0; !stop.stop_requested(); ++local) {
+    if (local % 256 == 0) {
+      std::lock_guard lock(corpus_lock);
+      pool.insert(pool.end(), corpus.begin() + static_cast<std::ptrdiff_t>(synced), corpus.end());
+      synced = corpus.size();
+    }
+
+    input = pool[rng() % pool.size()];
+    mutate(input, pool, rng, config.max_input);
+
+    std::fill(trace.begin(), trace.end(), 0);
+    console.feed(input);
+    vm.restore(snapshot);
+    (void)vm.execute();
+
+    const bool novel = merge_coverage(trace.data());
+    ++pending_execs;
+
+    switch (vm.stopped_by()) {
+    case StopReason::InvalidOpcode: {
+      // aynı adresteki crash'i bir kere kaydediyoruz (PC fetch'ten sonra bir ileride)
+      const auto site = static_cast<uint16_t>(vm.pc() - 1);
+      bool fresh;
+      {
+        std::lock_guard lock(corpus_lock);
+        fresh = crash_sites.insert(site).second;
+      }
+      if (fresh) {
+        flush_execs();
+        save("crash", crashes.fetch_add(1, std::memory_order_release), input);
+      }
+      break;
+    }
+    case StopReason::CycleLimit: {
+      flush_execs();
+      const uint64_t n = hangs.fetch_add(1, std::memory_order_release);
+      if (novel) {
+        save("hang", n, input);
+      }
+      break;
+    }
+    default:
+      if (novel) {
+        std::lock_guard lock(corpus_lock);
+        corpus.push_back(input);
+        save("queue", corpus.size(), input);
+      }
+      break;
+    }
+
+    if (pending_execs == EXEC_BATCH) {
+      flush_execs();
+    }
+  }
+  flush_execs();
+}
+
+[[nodiscard]] int Fuzzer::run() {
+  if (!config.output_dir.empty()) {
+    for (const char *kind : {"crash", "hang", "queue"}) {
+      std::filesystem::create_directories(config.output_dir / kind);
+    }
+  }
+
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+  auto report = [&] {
+    const std::chrono::duration<double> elapsed = clock::now() - start;
+    // önce crash/hang (acquire), sonra execs: görülen her hang'in exec'i de görünüyor
+    const uint64_t crash_count = crashes.load(std::memory_order_acquire);
+    const uint64_t hang_count = hangs.load(std::memory_order_acquire);
+    const uint64_t done = execs.load(std::memory_order_relaxed);
+    size_t corpus_size;
+    {
+      std::lock_guard lock(corpus_lock);
+      corpus_size = corpus.size();
+    }
+    std::cerr << "[" << std::fixed << std::setprecision(1) << elapsed.count() << "s] exec: " << done
+              << " (" << std::setprecision(0) << static_cast<double>(done) / elapsed.count()
+              << "/s), korpus: " << corpus_size << ", kenar: " << edges.load()
+              << ", crash: " << crash_count << ", hang: " << hang_count << "\n";
+  };
+
+  {
+    std::vector<std::jthread> threads;
+    for (unsigned id = 0; id < config.workers; ++id) {
+      threads.emplace_back([this, id](std::stop_token stop) { worker(stop, id); });
+    }
+
+    auto next_report = start + std::chrono::seconds(1);
+    while (clock::now() - start < config.duration &&
+           (config.max_execs == 0 || execs.load(std::memory_order_relaxed) < config.max_execs)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      if (clock::now() >= next_report) {
+        report();
+        next_report += std::chrono::seconds(1);
+      }
+    }
+
+    for (auto &thread : threads) {
+      thread.request_stop();
+    }
+  } // worker'lar burada join ediliyor
+
+  report();
+  return crashes.load() > 0 ? 1 : 0;
+}
@@ -0,0 +1,99 @@
+// lc3-fuzz: LC-3 imajlarını klavye girdisiyle fuzzlamak için snapshot tabanlı harness (fuzz.h)
+
+#include "fuzz.h"
+#include "vm.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// İmajın ilk giriş isteğine kadar çalışmasına izin verilen süre
+inline constexpr uint64_t BOOT_CYCLE_LIMIT = 500'000'000;
+
+static std::vector<FuzzInput> read_seeds(const std::filesystem::path &dir) {
+  std::vector<FuzzInput> seeds;
+  for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+    std::ifstream file(entry.path(), std::ios::binary);
+    seeds.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  return seeds;
+}
+
+int main(int argc, const char *argv[]) {
+  try {
+    FuzzConfig config;
+    config.workers = std::max(std::thread::hardware_concurrency(), 1u);
+    config.seed = std::random_device{}();
+
+    bool cycles_given = false;
+
+    std::vector<const char *> args{argv[0]};
+    for (int i = 1; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      const bool has_value = i + 1 < argc;
+      if (arg == "-j" && has_value) {
+        config.workers = static_cast<unsigned>(std::stoul(argv[++i]));
+      } else if (arg == "-t" && has_value) {
+        config.duration = std::chrono::seconds(std::stoll(argv[++i]));
+      } else if (arg == "-n" && has_value) {
+        config.max_execs = std::stoull(argv[++i]);
+      } else if (arg == "--max-cycles" && has_value) {
+        config.max_cycles = std::stoull(argv[++i]);
+        cycles_given = true;
+      } else if (arg == "--max-len" && has_value) {
+        config.max_input = std::stoul(argv[++i]);
+      } else if (arg == "--seed" && has_value) {
+        config.seed = std::stoull(argv[++i]);
+      } else if (arg == "-i" && has_value) {
+        config.seeds = read_seeds(argv[++i]);
+      } else if (arg == "-o" && has_value) {
+        config.output_dir = argv[++i];
+      } else {
+        args.push_back(argv[i]);
+      }
+    }
+
+    if (args.size() < 2) {
+      std::cerr << "Kullanim: lc3-fuzz [-j N] [-t SANIYE] [-n EXEC] [--max-cycles N] [--max-len N]\n"
+                   "                [--seed N] [-i SEED_DIZINI] [-o CIKTI_DIZINI] image-file ...\n";
+      return 1;
+    }
+
+    // imajı yükleyip ilk giriş isteğine kadar koşturuyoruz, fork server buradan başlıyor.
+    // Boş imajdan sayfalı açıyoruz ki kirli sayfa sayısı snapshot'ın boyunu göstersin.
+    VirtualMachine boot(std::make_shared<const Memory>());
+    FuzzConsole silent;
+    boot.set_console(silent);
+    if (!boot.load_images(static_cast<int>(args.size()), args.data())) {
+      return 1;
+    }
+    boot.reset();
+    if (!boot.run_to_input(BOOT_CYCLE_LIMIT)) {
+      std::cerr << "Hata: Program girdi okumadan durdu ya da zaman asimina ugradi.\n";
+      return 1;
+    }
+    Snapshot snapshot = boot.snapshot();
+    // açılışı uzun süren imaj tuşlar arasında da o kadar iş yapabilir
+    if (!cycles_given) {
+      config.max_cycles = std::max(config.max_cycles, snapshot.cycle_count * FUZZ_BOOT_CYCLE_FACTOR);
+    }
+    std::cerr << "Snapshot: PC=0x" << std::hex << boot.pc() << std::dec << ", kirli sayfa: "
+              << boot.private_page_count() << ", worker: " << config.workers
+              << ", test butcesi: " << config.max_cycles << " cycle\n";
+
+    Fuzzer fuzzer(std::move(snapshot), std::move(config));
+    return fuzzer.run();
+  } catch (const std::exception &e) {
+    std::cerr << "Hata: " << e.what() << std::endl;
+    return 1;
+  }
+}
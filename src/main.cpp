@@ -1,20 +1,74 @@
 //https://www.jmeiners.com/lc3-vm/
 
+#include "smp.h"
 #include "terminal.h"
 #include "vm.h"
 
+#include <cmath>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
+#include <vector>
 
 int main(int argc, const char *argv[]) {
   try {
     std::signal(SIGINT, handle_interrupt);
 
-    VirtualMachine vm;
+    // seçenekleri ayıklayıp kalanları (image dosyaları) run'a veriyoruz
+    int cores = 1;
+    TimingConfig timing;
+    const char *telemetry_path = nullptr;
+    std::vector<const char *> args{argv[0]};
+    for (int i = 1; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      if (arg == "--cores" && i + 1 < argc) {
+        cores = std::stoi(argv[++i]);
+      } else if (arg == "--clock" && i + 1 < argc) {
+        timing.mode = ExecutionMode::Throttled;
+        timing.target_mhz = std::stod(argv[++i]);
+      } else if (arg == "--turbo") {
+        timing.mode = ExecutionMode::Turbo;
+        timing.report = true;
+      } else if (arg == "--telemetry" && i + 1 < argc) {
+        telemetry_path = argv[++i];
+      } else {
+        args.push_back(argv[i]);
+      }
+    }
+
+    if (cores < 1 || cores > 0xFFFF) {
+      throw std::invalid_argument("--cores 1 ile 65535 arasinda olmali");
+    }
+    if (timing.mode == ExecutionMode::Throttled &&
+        !(std::isfinite(timing.target_mhz) && timing.target_mhz > 0.0)) {
+      throw std::invalid_argument("--clock pozitif ve sonlu bir MHz degeri olmali");
+    }
+
+    // VM'lerden önce kurulup sonra yıkılmalı, VM'ler sayaçlarını ona yazıyor
+    std::optional<TelemetryServer> telemetry;
+    if (telemetry_path != nullptr) {
+      telemetry.emplace(telemetry_path);
+    }
+
     TerminalManager terminal_manager;
-    return vm.run(argc, argv);
+    if (cores > 1) {
+      SmpMachine machine(static_cast<uint16_t>(cores));
+      machine.set_timing(timing);
+      if (telemetry) {
+        machine.set_telemetry(*telemetry);
+      }
+      return machine.run(static_cast<int>(args.size()), args.data());
+    }
+
+    VirtualMachine vm;
+    vm.set_timing(timing);
+    if (telemetry) {
+      vm.set_telemetry(telemetry->attach());
+    }
+    return vm.run(static_cast<int>(args.size()), args.data());
   } catch (const std::exception &e) {
     std::cerr << "Hata: " << e.what() << std::endl;
     return 1;
   }
-}
\ No newline at end of file
+}
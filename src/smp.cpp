@@ -0,0 +1,152 @@
+#include "smp.h"
+
+#include <atomic>
+#include <thread>
+
+// ============================================================================
+// SMP MMIO
+// ============================================================================
+
+[[nodiscard]] uint16_t VirtualMachine::smp_mmio_read(uint16_t address) {
+  switch (static_cast<MemoryMappedRegister>(address)) {
+  case MemoryMappedRegister::CPUID:
+    return core_id;
+  case MemoryMappedRegister::NCPU:
+    return bus->core_count;
+
+  case MemoryMappedRegister::MBSR: {
+    Mailbox &box = bus->mailboxes[core_id];
+    std::lock_guard lock(box.lock);
+    return box.inbox.empty() ? 0 : static_cast<uint16_t>(1 << 15);
+  }
+
+  case MemoryMappedRegister::MBDR: {
+    // boş kutudan okuma 0 döner, misafir önce MBSR'ye bakmalı (KBSR gibi)
+    Mailbox &box = bus->mailboxes[core_id];
+    std::lock_guard lock(box.lock);
+    if (box.inbox.empty()) {
+      return 0;
+    }
+    uint16_t val = box.inbox.front();
+    box.inbox.pop_front();
+    return val;
+  }
+
+  case MemoryMappedRegister::MBDST:
+    return mailbox_target;
+  case MemoryMappedRegister::ATAR:
+    return atomic_address;
+  case MemoryMappedRegister::ATEXP:
+    return atomic_expected;
+  case MemoryMappedRegister::ATNEW:
+    return atomic_new;
+
+  case MemoryMappedRegister::ATTAS:
+    // test-and-set: [ATAR] = 1, eski değer döner. 0 dönerse kilit bizim.
+    return std::atomic_ref<uint16_t>(memory_words[atomic_address])
+        .exchange(1, std::memory_order_seq_cst);
+
+  case MemoryMappedRegister::ATCAS: {
+    // [ATAR] == ATEXP ise [ATAR] = ATNEW. Her durumda eski değer döner,
+    // misafir dönen değeri ATEXP ile karşılaştırarak başarıyı anlar.
+    uint16_t expected = atomic_expected;
+    std::atomic_ref<uint16_t>(memory_words[atomic_address])
+        .compare_exchange_strong(expected, atomic_new, std::memory_order_seq_cst);
+    return expected;
+  }
+
+  default:
+    // aralıkta olup tanımlı olmayan adresler 0 okunur
+    return 0;
+  }
+}
+
+void VirtualMachine::smp_mmio_write(uint16_t address, uint16_t val) {
+  switch (static_cast<MemoryMappedRegister>(address)) {
+  case MemoryMappedRegister::MBDR: {
+    if (mailbox_target >= bus->core_count) {
+      break; // olmayan çekirdeğe gönderilen mesaj düşürülür
+    }
+    Mailbox &box = bus->mailboxes[mailbox_target];
+    std::lock_guard lock(box.lock);
+    box.inbox.push_back(val);
+    break;
+  }
+  case MemoryMappedRegister::MBDST:
+    mailbox_target = val;
+    break;
+  case MemoryMappedRegister::ATAR:
+    atomic_address = val;
+    break;
+  case MemoryMappedRegister::ATEXP:
+    atomic_expected = val;
+    break;
+  case MemoryMappedRegister::ATNEW:
+    atomic_new = val;
+    break;
+  default:
+    // CPUID, NCPU, MBSR, ATTAS, ATCAS salt okunur
+    break;
+  }
+}
+
+// ============================================================================
+// SmpMachine
+// ============================================================================
+
+SmpMachine::SmpMachine(uint16_t core_count)
+    : memory(std::make_shared<Memory>()), bus(core_count) {
+  cores.reserve(core_count);
+  for (uint16_t id = 0; id < core_count; ++id) {
+    cores.push_back(std::make_unique<VirtualMachine>(memory, &bus, id));
+  }
+}
+
+// her çekirdeğin kendi sanal saati var, throttled modda her biri hedef frekansta koşar
+void SmpMachine::set_timing(const TimingConfig &config) {
+  for (auto &core : cores) {
+    core->set_timing(config);
+  }
+}
+
+void SmpMachine::set_telemetry(TelemetryServer &server) {
+  for (auto &core : cores) {
+    core->set_telemetry(server.attach());
+  }
+}
+
+[[nodiscard]] int SmpMachine::run(int argc, const char *argv[]) {
+  // bellek ortak olduğu için imajı bir kere yüklemek yeterli
+  if (!cores.front()->load_images(argc, argv)) {
+    return 1;
+  }
+
+  std::vector<int> results(cores.size(), 0);
+  bus.stopping.store(false);
+  bus.running_cores.store(static_cast<uint16_t>(cores.size()));
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(cores.size());
+    for (size_t i = 0; i < cores.size(); ++i) {
+      cores[i]->reset();
+      threads.emplace_back([this, &results, i] {
+        results[i] = cores[i]->execute();
+        // hatayla duran çekirdek diğerlerini de durdursun, yoksa join'de takılırız
+        if (results[i] != 0) {
+          bus.stopping.store(true, std::memory_order_relaxed);
+        }
+        // durma sebebi ne olursa olsun; mesajı son çıkan çekirdek yazıyor
+        if (bus.running_cores.fetch_sub(1) == 1) {
+          cores[i]->announce_halt();
+        }
+      });
+    }
+  } // jthread'ler burada join ediliyor
+
+  for (int result : results) {
+    if (result != 0) {
+      return result;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+inline constexpr std::array<const char *, TELEMETRY_TRAP_SLOTS> TRAP_NAMES = {
+    "GETC", "OUT", "PUTS", "IN", "PUTSP", "HALT", "diger"};
+
+static const char *state_name(VmState state) {
+  switch (state) {
+  case VmState::Idle:
+    return "idle";
+  case VmState::Running:
+    return "running";
+  case VmState::WaitingInput:
+    return "waiting_input";
+  case VmState::Stopped:
+    return "stopped";
+  }
+  return "?";
+}
+
+TelemetryServer::TelemetryServer(std::filesystem::path socket_path) : path(std::move(socket_path)) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  const std::string name = path.string();
+  if (name.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("Telemetri soket yolu cok uzun: " + name);
+  }
+  std::memcpy(address.sun_path, name.c_str(), name.size() + 1);
+
+  listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listen_fd == -1) {
+    throw std::runtime_error("Telemetri soketi olusturulamadi");
+  }
+
+  // önceki çalışmadan kalan soket dosyası bind'ı engellemesin; soket olmayan bir
+  // dosyayı (yanlış verilmiş yol) asla silmiyoruz
+  struct stat existing{};
+  if (::lstat(name.c_str(), &existing) == 0) {
+    if (!S_ISSOCK(existing.st_mode)) {
+      ::close(listen_fd);
+      throw std::runtime_error("Telemetri yolu soket olmayan bir dosya: " + name);
+    }
+    ::unlink(name.c_str());
+  }
+  if (bind(listen_fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == -1 ||
+      listen(listen_fd, 8) == -1) {
+    ::close(listen_fd);
+    throw std::runtime_error("Telemetri soketi dinlenemiyor: " + name + " (" + std::strerror(errno) + ")");
+  }
+
+  thread = std::jthread([this](std::stop_token stop) { serve(stop); });
+}
+
+TelemetryServer::~TelemetryServer() {
+  // soket kapanmadan önce thread dursun
+  thread.request_stop();
+  if (thread.joinable()) {
+    thread.join();
+  }
+  ::close(listen_fd);
+  ::unlink(path.c_str());
+}
+
+[[nodiscard]] VmTelemetry &TelemetryServer::attach() {
+  std::lock_guard lock(slots_lock);
+  return *slots.emplace_back(std::make_unique<VmTelemetry>());
+}
+
+void TelemetryServer::serve(std::stop_token stop) {
+  pollfd listener{.fd = listen_fd, .events = POLLIN, .revents = 0};
+  while (!stop.stop_requested()) {
+    // accept'te sonsuza kadar bloklanmayalım, kapanışta stop_token'a bakabilelim
+    if (poll(&listener, 1, 100) <= 0) {
+      continue;
+    }
+    const int client = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client == -1) {
+      continue;
+    }
+
+    const std::string text = report();
+    size_t sent = 0;
+    while (sent < text.size()) {
+      const ssize_t n = send(client, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+      if (n <= 0) {
+        break; // istemci erken kapattı
+      }
+      sent += static_cast<size_t>(n);
+    }
+    ::close(client);
+  }
+}
+
+// Sayaçlar sadece burada, biri sorduğunda okunuyor.
+[[nodiscard]] std::string TelemetryServer::report() {
+  const int64_t now = telemetry_now_ns();
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  out << "{\"vms\": [";
+
+  std::lock_guard lock(slots_lock);
+  for (size_t id = 0; id < slots.size(); ++id) {
+    const VmTelemetry &vm = *slots[id];
+    const VmState state = vm.state.load(std::memory_order_relaxed);
+    const uint64_t instructions = vm.instructions.load(std::memory_order_relaxed);
+    const int64_t started = vm.started_ns.load(std::memory_order_relaxed);
+
+    // devam eden bekleme de bekleme süresine sayılıyor
+    int64_t waited = vm.input_wait_ns.load(std::memory_order_relaxed);
+    if (state == VmState::WaitingInput) {
+      waited += now - vm.wait_started_ns.load(std::memory_order_relaxed);
+    }
+    // durmuş VM'in süresi duruş anında donuyor
+    const int64_t until = state == VmState::Stopped ? vm.published_ns.load(std::memory_order_relaxed) : now;
+    const double elapsed = state == VmState::Idle ? 0.0 : static_cast<double>(until - started) / 1e9;
+    const double wait_seconds = static_cast<double>(waited) / 1e9;
+    const double execute_seconds = std::max(elapsed - wait_seconds, 0.0);
+    // KBSR yoklarken dönen komutlar bekleme sayılıyor
+    const uint64_t executed =
+        instructions - std::min(instructions, vm.wait_instructions.load(std::memory_order_relaxed));
+    const double average_mips =
+        execute_seconds > 0 ? static_cast<double>(executed) / execute_seconds / 1e6 : 0.0;
+    const double current_mips =
+        state == VmState::Running ? vm.current_mips.load(std::memory_order_relaxed) : 0.0;
+
+    out << (id ? ", " : "") << "{\"id\": " << id << ", \"state\": \"" << state_name(state)
+        << "\", \"pc\": " << vm.pc.load(std::memory_order_relaxed)
+        << ", \"instructions\": " << instructions
+        << ", \"cycles\": " << vm.cycles.load(std::memory_order_relaxed)
+        << ", \"seconds_since_update\": "
+        << static_cast<double>(now - vm.published_ns.load(std::memory_order_relaxed)) / 1e9
+        << ", \"current_mips\": " << current_mips << ", \"average_mips\": " << average_mips
+        << ", \"execute_seconds\": " << execute_seconds
+        << ", \"input_wait_seconds\": " << wait_seconds
+        << ", \"input_polls\": " << vm.input_polls.load(std::memory_order_relaxed)
+        << ", \"output_bytes\": " << vm.output_bytes.load(std::memory_order_relaxed)
+        << ", \"traps\": {";
+    for (size_t t = 0; t < TELEMETRY_TRAP_SLOTS; ++t) {
+      out << (t ? ", " : "") << "\"" << TRAP_NAMES[t]
+          << "\": " << vm.traps[t].load(std::memory_order_relaxed);
+    }
+    out << "}}";
+  }
+  out << "]}\n";
+  return out.str();
+}
@@ -0,0 +1,65 @@
+#include "timing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+// Throttled modda her cycle'da değil, bu kadar sanal zamanda bir host saatine bakıyoruz.
+// Küçük parçalarla uyumak (usleep(1) gibi) CPU'yu boşa yakar, 20ms makul bir denge.
+inline constexpr std::chrono::milliseconds SYNC_CHUNK{20};
+
+// Host bu kadar geride kalırsa (GETC'de beklerken ya da makine yoğunken) aradaki farkı
+// kapatmak için patlama halinde koşmak yerine referans noktasını yeniden alıyoruz.
+inline constexpr std::chrono::milliseconds MAX_LAG{100};
+
+Timing::Timing(const TimingConfig &config) : config(config) {
+  if (config.mode == ExecutionMode::Throttled) {
+    // inf/nan ya da uint64_t'ye sığmayan değerin cast'i tanımsız davranış
+    const double cycles =
+        config.target_mhz * static_cast<double>(std::chrono::microseconds(SYNC_CHUNK).count());
+    if (!std::isfinite(cycles) || !(cycles > 0.0) || cycles >= static_cast<double>(NO_SYNC)) {
+      throw std::invalid_argument("Hedef frekans pozitif ve sonlu olmali");
+    }
+    chunk_cycles = std::max<uint64_t>(static_cast<uint64_t>(cycles), 1);
+  }
+}
+
+[[nodiscard]] uint64_t Timing::start(uint64_t cycles) {
+  start_time = base_time = clock::now();
+  base_cycles = cycles;
+  return config.mode == ExecutionMode::Throttled ? cycles + chunk_cycles : NO_SYNC;
+}
+
+[[nodiscard]] uint64_t Timing::sync(uint64_t cycles) {
+  // MHz = cycle / mikrosaniye
+  const auto virtual_elapsed = std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double, std::micro>(
+          static_cast<double>(cycles - base_cycles) / config.target_mhz));
+  const auto target = base_time + virtual_elapsed;
+  const auto now = clock::now();
+
+  if (now < target) {
+    std::this_thread::sleep_until(target);
+  } else if (now - target > MAX_LAG) {
+    base_time = now;
+    base_cycles = cycles;
+  }
+
+  return cycles + chunk_cycles;
+}
+
+void Timing::report(uint64_t cycles, uint64_t instructions) const {
+  if (!config.report) {
+    return;
+  }
+
+  const std::chrono::duration<double, std::micro> elapsed = clock::now() - start_time;
+  const double mhz = elapsed.count() > 0 ? static_cast<double>(cycles) / elapsed.count() : 0.0;
+
+  std::cerr << "Sanal cycle: " << cycles << ", komut: " << instructions
+            << ", sure: " << std::fixed << std::setprecision(3) << elapsed.count() / 1e6
+            << " s, efektif: " << std::setprecision(2) << mhz << " MHz\n";
+}
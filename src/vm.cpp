@@ -1,63 +1,235 @@
 #include "vm.h"
+#include "smp.h"
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
 
 // ============================================================================
-// Keyboard Check
+// Construction
 // ============================================================================
 
-[[nodiscard]] bool VirtualMachine::check_key() {
-  // klavye okumasına bakılıyor [[nodiscard]] ile bunun kontrol edilip
-  // edilmediğini kontrol ediyoruz.
-  fd_set readfds;
-  FD_ZERO(&readfds);
-  FD_SET(STDIN_FILENO, &readfds);
+// Tek başına VM snapshot paylaşmıyor, copy-on-write'a gerek yok: düz bellek.
+VirtualMachine::VirtualMachine()
+    : memory_mode(MemoryMode::Flat), memory(std::make_shared<Memory>()),
+      memory_words(memory->data()) {
+  for (size_t page = 0; page < PAGE_COUNT; ++page) {
+    write_pages[page] = memory_words + page * PAGE_WORDS;
+    read_pages[page] = write_pages[page];
+  }
+}
 
-  struct timeval timeout{.tv_sec = 0, .tv_usec = 0};
+VirtualMachine::VirtualMachine(std::shared_ptr<const Memory> image) : image(std::move(image)) {
+  for (size_t page = 0; page < PAGE_COUNT; ++page) {
+    read_pages[page] = this->image->data() + page * PAGE_WORDS;
+  }
+}
 
-  // POLLING-> herhangi bir bekleme yapılmıyor anlık olarak kontrol ediliyor.
-  // LC-3'te bu kullanılıyor.
-  /*
-  Interrupt-Driven vs Polling
-  Continuing with the above keyboard example, the question is how does the
-  microprocessor know when the ready bit has been set? One way is by polling
-  where the microprocessor is continuously checking to see if the ready bit has
-  been set or not. If it is set then it will go and read in the key. This method
-  does not require any extra hardware support but waste a lot of CPU time for
-  the microprocessor to continually check the ready bit. A more efficient
-  method, but requires extra hardware support, is to use an interrupt. The
-  microprocessor is doing its own thing until it is interrupted by the keyboard,
-  at which time it will then go and read in the key. The LC3 uses the polling
-  method.
-  https://hwang.lasierra.edu/~enoch/CPTG%20245/LC-3/LC-3%20InputOutput.pdf
-  */
+// SMP'de bellek zaten ortak ve yazılabilir, copy-on-write yok.
+VirtualMachine::VirtualMachine(std::shared_ptr<Memory> shared_memory, SmpBus *bus,
+                               uint16_t core_id)
+    : memory_mode(MemoryMode::Shared), memory(std::move(shared_memory)),
+      memory_words(memory->data()), bus(bus), core_id(core_id) {
+  for (size_t page = 0; page < PAGE_COUNT; ++page) {
+    write_pages[page] = memory_words + page * PAGE_WORDS;
+    read_pages[page] = write_pages[page];
+  }
+}
 
-  /*
-  extern int select (int __nfds, fd_set *__restrict __readfds,
-  fd_set *__restrict __writefds,
-  fd_set *__restrict __exceptfds,
-  struct timeval *__restrict __timeout);
-
-  Dosya ID'leri:  0   1   2   3   4   5  ...  1023   FD'lerin gösterimi
-  Bits:         [ 1 | 0 | 0 | 0 | 0 | 0 | ... | 0 ]
-                  ^
-             (Bizim Klavye - STDIN)
-  */
+// ============================================================================
+// Keyboard Check
+// ============================================================================
 
-  return select(1, // kaç tane fd'ye bakmak istiyorsak gibi düşünebiliriz.
-                &readfds, // klavyeden veri gelip gelmediğine bakılıyor.
-                nullptr, // yazma listesi ile ilgili bir şeyi kontrol etmiyoruz.
-                nullptr, // hata listesini de kontrol etmiyoruz.
-                &timeout // bekleme süresini ayarladığımız gibi veriyoruz.
-                ) > 0;   // 0 dan büyükse veri var demektir.
+[[nodiscard]] bool VirtualMachine::check_key() {
+  // select() ile yoklama TerminalConsole::key_ready içinde
+  if (input_barrier) {
+    stop(StopReason::InputBarrier);
+    return false;
+  }
+  if (console->key_ready()) {
+    return true;
+  }
+  if (console->at_end()) {
+    stop(StopReason::InputExhausted);
+  }
+  return false;
 }
 
 // ============================================================================
 // Memory Operations
 // ============================================================================
 
+// uint16_t adres her zaman MEMORY_MAX'ın içinde kaldığı için burada at() yerine [] yeterli.
+// SMP'de bellek ortak, bu yüzden erişimler atomic_ref üzerinden (sıralama kuralları smp.h'de).
+template <MemoryMode Mode> [[nodiscard]] uint16_t VirtualMachine::load(uint16_t address) {
+  if constexpr (Mode == MemoryMode::Flat) {
+    return memory_words[address];
+  } else if constexpr (Mode == MemoryMode::Shared) {
+    return std::atomic_ref<uint16_t>(memory_words[address]).load(std::memory_order_acquire);
+  } else {
+    return read_pages[address >> PAGE_BITS][address & PAGE_MASK];
+  }
+}
+
+template <MemoryMode Mode> void VirtualMachine::store(uint16_t address, uint16_t val) {
+  if constexpr (Mode == MemoryMode::Flat) {
+    memory_words[address] = val;
+  } else if constexpr (Mode == MemoryMode::Shared) {
+    std::atomic_ref<uint16_t>(memory_words[address]).store(val, std::memory_order_release);
+  } else {
+    const size_t page = address >> PAGE_BITS;
+    uint16_t *words = write_pages[page];
+    if (words == nullptr) {
+      words = copy_page(page);
+    }
+    words[address & PAGE_MASK] = val;
+  }
+}
+
+// sıcak döngünün dışındaki erişimler (TRAP, imaj yükleme, KBSR) için
+[[nodiscard]] uint16_t VirtualMachine::load(uint16_t address) {
+  switch (memory_mode) {
+  case MemoryMode::Flat:
+    return load<MemoryMode::Flat>(address);
+  case MemoryMode::Shared:
+    return load<MemoryMode::Shared>(address);
+  case MemoryMode::Paged:
+    break;
+  }
+  return load<MemoryMode::Paged>(address);
+}
+
+void VirtualMachine::store(uint16_t address, uint16_t val) {
+  switch (memory_mode) {
+  case MemoryMode::Flat:
+    store<MemoryMode::Flat>(address, val);
+    return;
+  case MemoryMode::Shared:
+    store<MemoryMode::Shared>(address, val);
+    return;
+  case MemoryMode::Paged:
+    break;
+  }
+  store<MemoryMode::Paged>(address, val);
+}
+
+// Paylaşılan sayfaya ilk yazma: sayfanın özel kopyasını çıkarıp tabloları ona çeviriyoruz.
+[[nodiscard]] uint16_t *VirtualMachine::copy_page(size_t page) {
+  if (!private_pages[page]) {
+    private_pages[page] = std::make_unique<Page>();
+  }
+  uint16_t *words = private_pages[page]->data();
+  std::copy_n(read_pages[page], PAGE_WORDS, words);
+  read_pages[page] = words;
+  write_pages[page] = words;
+  return words;
+}
+
+[[nodiscard]] std::shared_ptr<const Memory> VirtualMachine::snapshot_memory() const {
+  auto flat = std::make_shared<Memory>();
+  for (size_t page = 0; page < PAGE_COUNT; ++page) {
+    std::copy_n(read_pages[page], PAGE_WORDS, flat->data() + page * PAGE_WORDS);
+  }
+  return flat;
+}
+
+[[nodiscard]] Snapshot VirtualMachine::snapshot() const {
+  return Snapshot{.memory = snapshot_memory(),
+                  .reg = reg,
+                  .cycle_count = cycle_count,
+                  .instruction_count = instruction_count,
+                  .timer_interval = timer_interval,
+                  .timer_deadline = timer_deadline};
+}
+
+void VirtualMachine::restore(const Snapshot &snapshot) {
+  if (image == snapshot.memory) {
+    // fork server'ın sıcak yolu: sadece yazılmış sayfaları paylaşılan haline döndür,
+    // özel sayfaların kendisini bir sonraki kopya için saklıyoruz
+    for (size_t page = 0; page < PAGE_COUNT; ++page) {
+      if (write_pages[page] != nullptr) {
+        write_pages[page] = nullptr;
+        read_pages[page] = image->data() + page * PAGE_WORDS;
+      }
+    }
+  } else {
+    // düz VM de buradan sonra snapshot'ın sayfalarını paylaşıyor
+    memory_mode = MemoryMode::Paged;
+    memory.reset();
+    memory_words = nullptr;
+    image = snapshot.memory;
+    write_pages.fill(nullptr);
+    for (size_t page = 0; page < PAGE_COUNT; ++page) {
+      read_pages[page] = image->data() + page * PAGE_WORDS;
+    }
+  }
+
+  reg = snapshot.reg;
+  cycle_count = snapshot.cycle_count;
+  instruction_count = snapshot.instruction_count;
+  timer_interval = snapshot.timer_interval;
+  timer_deadline = snapshot.timer_deadline;
+  running = true;
+  stop_reason = StopReason::None;
+}
+
+[[nodiscard]] size_t VirtualMachine::private_page_count() const {
+  return static_cast<size_t>(std::ranges::count_if(
+      write_pages, [](const uint16_t *words) { return words != nullptr; }));
+}
+
 void VirtualMachine::mem_write(uint16_t address, uint16_t val) {
-  memory.at(address) = val;
+  if (address < MMIO_BEGIN) {
+    store(address, val);
+    return;
+  }
+  mmio_write(address, val);
 }
 [[nodiscard]] uint16_t VirtualMachine::mem_read(uint16_t address) {
+  if (address < MMIO_BEGIN) {
+    return load(address);
+  }
+  return mmio_read(address);
+}
+
+// sıcak yol: komut okuma ve sıradan yüklemeler cihaz kontrollerine hiç girmesin.
+// Cihazlar (saat, KBSR yoklaması) sayaçları okuduğu için önce onları yazıyoruz.
+template <MemoryMode Mode>
+void VirtualMachine::mem_write(uint16_t address, uint16_t val, LiveCounters &live) {
+  if (address < MMIO_BEGIN) [[likely]] {
+    store<Mode>(address, val);
+    return;
+  }
+  sync_counters(live);
+  mmio_write(address, val);
+}
+template <MemoryMode Mode>
+[[nodiscard]] uint16_t VirtualMachine::mem_read(uint16_t address, LiveCounters &live) {
+  if (address < MMIO_BEGIN) [[likely]] {
+    return load<Mode>(address);
+  }
+  sync_counters(live);
+  return mmio_read(address);
+}
+
+void VirtualMachine::mmio_write(uint16_t address, uint16_t val) {
+  if (bus != nullptr && address >= SMP_MMIO_BEGIN && address <= SMP_MMIO_END) {
+    smp_mmio_write(address, val);
+    return;
+  }
+  if (address >= TIMER_MMIO_BEGIN && address <= TIMER_MMIO_END) {
+    timer_mmio_write(address, val);
+    return;
+  }
+  store(address, val);
+}
+[[nodiscard]] uint16_t VirtualMachine::mmio_read(uint16_t address) {
+  if (bus != nullptr && address >= SMP_MMIO_BEGIN && address <= SMP_MMIO_END) {
+    return smp_mmio_read(address);
+  }
+  if (address >= TIMER_MMIO_BEGIN && address <= TIMER_MMIO_END) {
+    return timer_mmio_read(address);
+  }
   
   //<utily>'de bulunan fonksiyon içi yazılmış template, static cast alternatifi(detayına bakınız) fonksiyon
   if (address == to_underlying(MemoryMappedRegister::KBSR)) {
@@ -72,13 +244,27 @@ void VirtualMachine::mem_write(uint16_t address, uint16_t val) {
     gerçekleştiririz
     */
 
-    if (check_key()) // klavyeden giriş yaptıysak bu fonksiyon sayesinde kontrol
+    // SMP'de klavye ortak; check_key ile cin.get arasına başka çekirdek girmesin.
+    // Başka çekirdek GETC/IN'de tuş bekliyorsa beklemeden "tuş yok" dönüyoruz.
+    std::unique_lock<std::mutex> input_guard;
+    if (bus != nullptr) {
+      input_guard = std::unique_lock(bus->input_lock, std::try_to_lock);
+    }
+
+    if ((bus == nullptr || input_guard.owns_lock()) &&
+        check_key()) // klavyeden giriş yaptıysak bu fonksiyon sayesinde kontrol
                      // yapıyoruz
     {
-      memory.at(to_underlying(MemoryMappedRegister::KBSR)) = (1 << 15); 
-      
       // KBSR'in 15. biti (ready bit) 1 olursa karakterin geldiği anlaşılıyor -.obj dosyası içinde-
-      memory.at(to_underlying(MemoryMappedRegister::KBDR)) = static_cast<uint16_t>(std::cin.get());
+      const auto key = static_cast<uint16_t>(console->get());
+      end_poll_wait();
+      if (bus != nullptr) {
+        keyboard_status = (1 << 15);
+        keyboard_data = key;
+        return keyboard_status;
+      }
+      store(to_underlying(MemoryMappedRegister::KBSR), (1 << 15));
+      store(to_underlying(MemoryMappedRegister::KBDR), key);
     }
 
     /*
@@ -98,10 +284,65 @@ void VirtualMachine::mem_write(uint16_t address, uint16_t val) {
     */
 
     else {
-      memory.at(to_underlying(MemoryMappedRegister::KBSR)) = 0;
+      ++input_polls;
+      // oyunlar tuşu KBSR'yi yoklayarak bekliyor; ilk boş yoklamadan tuş gelene kadar
+      // geçen süre telemetride girdi beklemesi sayılıyor (saat sadece ilk yoklamada okunuyor)
+      if (telemetry != nullptr && poll_wait_began_ns == 0) {
+        poll_wait_began_ns = telemetry_now_ns();
+        poll_wait_began_instructions = instruction_count;
+      }
+      if (bus != nullptr) {
+        keyboard_status = 0;
+        return keyboard_status;
+      }
+      store(to_underlying(MemoryMappedRegister::KBSR), 0);
     }
   }
-  return memory.at(address);
+  // SMP'de KBDR çekirdeğin kendi mandalından, son KBSR'de yakaladığı tuş
+  if (bus != nullptr && address == to_underlying(MemoryMappedRegister::KBDR)) {
+    return keyboard_data;
+  }
+  return load(address);
+}
+
+// ============================================================================
+// Virtual Clock / Timer
+// ============================================================================
+
+void VirtualMachine::set_timing(const TimingConfig &config) { timing = Timing(config); }
+
+[[nodiscard]] uint16_t VirtualMachine::timer_mmio_read(uint16_t address) {
+  switch (static_cast<MemoryMappedRegister>(address)) {
+  case MemoryMappedRegister::CLKLO:
+    // 32 bitlik sayacı iki okumada tutarlı görmek için üst yarıyı burada kilitliyoruz
+    clock_high_latch = static_cast<uint16_t>(cycle_count >> 16);
+    return static_cast<uint16_t>(cycle_count);
+  case MemoryMappedRegister::CLKHI:
+    return clock_high_latch;
+
+  case MemoryMappedRegister::TMSR: {
+    if (timer_interval == 0 || cycle_count < timer_deadline) {
+      return 0;
+    }
+    // periyodik: kaçırılan periyotları atlayıp bir sonraki sınıra geçiyoruz, faz kaymıyor
+    const uint64_t missed = (cycle_count - timer_deadline) / timer_interval + 1;
+    timer_deadline += missed * timer_interval;
+    return static_cast<uint16_t>(1 << 15);
+  }
+
+  case MemoryMappedRegister::TMIR:
+    return static_cast<uint16_t>(timer_interval / TIMER_TICK_CYCLES);
+  default:
+    return 0;
+  }
+}
+
+void VirtualMachine::timer_mmio_write(uint16_t address, uint16_t val) {
+  if (static_cast<MemoryMappedRegister>(address) == MemoryMappedRegister::TMIR) {
+    timer_interval = static_cast<uint64_t>(val) * TIMER_TICK_CYCLES;
+    timer_deadline = cycle_count + timer_interval;
+  }
+  // CLKLO, CLKHI ve TMSR salt okunur
 }
 
 // ============================================================================
@@ -146,10 +387,12 @@ void VirtualMachine::read_image_file(std::ifstream &file) {
 
   origin = std::byteswap(origin);
 
-  const uint16_t max_read = static_cast<uint16_t>(MEMORY_MAX - origin);
-  uint16_t *p = memory.data() + origin;
+  // sayfalar paylaşılıyor olabilir, bu yüzden önce geçici tampona okuyup sonra store ile yazıyoruz
+  const size_t max_read = static_cast<size_t>(MEMORY_MAX - origin);
+  std::vector<uint16_t> buffer(max_read);
+  uint16_t *p = buffer.data();
 
-  file.read(reinterpret_cast<char *>(p), max_read * sizeof(uint16_t));
+  file.read(reinterpret_cast<char *>(p), static_cast<std::streamsize>(max_read * sizeof(uint16_t)));
 
   // static_cast ile tekrardan düzenlenebilir.  gcount long int dönüyor bundan dolayı static_cast gerekiyor
   const auto items_read = static_cast<size_t>(file.gcount()) / sizeof(uint16_t);
@@ -166,6 +409,11 @@ void VirtualMachine::read_image_file(std::ifstream &file) {
       p,              // OutputIterator __result çıkışın yazılacağı yer
       [](uint16_t val) { return std::byteswap(val);}  //  _unary_op fonksiyon yazmak yerine lambda ile hallediyoruz.
   );
+
+  for (size_t i = 0; i < items_read; ++i) {
+    store(static_cast<uint16_t>(origin + i), p[i]);
+  }
+  segments.push_back({.origin = origin, .length = items_read});
 }
 
 
@@ -255,6 +503,8 @@ void VirtualMachine::process_NOT(uint16_t instr) {
 // ------------------------------------------------------------------
 
 void VirtualMachine::process_BR(uint16_t instr) {
+  uint16_t &pc = reg[to_underlying(Register::PC)];
+  const uint16_t from = pc;
   uint16_t pc_offset = sign_extend(instr & 0x1FF, 9);
   uint16_t cond_flag = (instr >> 9) & 0x7;
 
@@ -265,8 +515,10 @@ void VirtualMachine::process_BR(uint16_t instr) {
     //  örnek if(x <=0) dersek condflag 110 ise ve x te 0 ya da 0 dan küçükse zıplarız 
     //  condflags 110 küçük veya 0 demek yani negative = 1 zero = 1 positive = 0 -> küçük veya eşit  
     //      (nzp: negative zero positive)
-    reg[to_underlying(Register::PC)] += pc_offset; // sadece 0 göre bakılıyor DİKKAT ET!!!!
+    pc += pc_offset; // sadece 0 göre bakılıyor DİKKAT ET!!!!
   }
+  // fuzzing: dallanmanın iki yönü de ayrı kenar
+  record_edge(from, pc);
 }
 
 // JMP (Jump) - Atlama / RET (Return)
@@ -276,10 +528,13 @@ void VirtualMachine::process_BR(uint16_t instr) {
 // ------------------------------------------------------------------
 
 void VirtualMachine::process_JMP(uint16_t instr) {
+  uint16_t &pc = reg[to_underlying(Register::PC)];
+  const uint16_t from = pc;
   uint16_t r1 = (instr >> 6) & 0x7; // BaseR (opcodes kısmında gösteriliyor)
                                     // değerine göre registera koşulsuz atlar
-  reg[to_underlying(Register::PC)] = reg[r1]; // atlamayı sağlar. Koşullu atlama JSR'de yapılıyor. İlk 4 bit ve
+  pc = reg[r1]; // atlamayı sağlar. Koşullu atlama JSR'de yapılıyor. İlk 4 bit ve
                // BaseR bitleri hariç diğer bitler herhangi bir işe yaramıyor.
+  record_edge(from, pc);
 }
 
 // JSR (Jump to Subroutine) - Alt Programa Atlama (PCoffset Modu)
@@ -293,19 +548,22 @@ void VirtualMachine::process_JMP(uint16_t instr) {
 // ------------------------------------------------------------------
 
 void VirtualMachine::process_JSR(uint16_t instr) {
-  reg[to_underlying(Register::R7)] = reg[to_underlying(Register::PC)]; 
+  uint16_t &pc = reg[to_underlying(Register::PC)];
+  const uint16_t from = pc;
+  reg[to_underlying(Register::R7)] = pc; 
   // Geri dönebilmek amacıyla reg[R_R7]'de şu anki adresimizi tutuyoruz.
   uint16_t flag = (instr >> 11) & 0x1;
 
   if (flag) /* Jump to Subroutine - JSR */
   {
     uint16_t pc_offset = sign_extend(instr & 0x7FF, 11);
-    reg[to_underlying(Register::PC)] += pc_offset;
+    pc += pc_offset;
   } else /* Jump to Subroutine Register - JSRR */
   {
     uint16_t r1 = (instr >> 6) & 0x7;
-    reg[to_underlying(Register::PC)] = reg[r1];
+    pc = reg[r1];
   }
+  record_edge(from, pc);
 }
 
 // LD (Load) - PC'ye Göre Yükleme
@@ -313,13 +571,14 @@ void VirtualMachine::process_JSR(uint16_t instr) {
 //  0   0   1   0 |     DR     |             PCoffset9
 // ------------------------------------------------------------------
 
-void VirtualMachine::process_LD(uint16_t instr) 
+template <MemoryMode Mode>
+void VirtualMachine::process_LD(uint16_t instr, LiveCounters &live) 
 // Herhangi bir adrese gidip oradaki adrese göre atlamıyor. Direkt PCoffset9'a göre atlıyor.
 // Dikkat et LDI'da mem_read içinde mem_read çalıştırıyoruz. Aşamalı atlanıyor. Çekirge 2 zıplıyor.
 {
   uint16_t r0 = (instr >> 9) & 0x7;
   uint16_t pc_offset = sign_extend(instr & 0x1FF, 9);
-  reg[r0] = mem_read(reg[to_underlying(Register::PC)] + pc_offset);
+  reg[r0] = mem_read<Mode>(reg[to_underlying(Register::PC)] + pc_offset, live);
   update_flags(r0);
 }
 
@@ -328,7 +587,8 @@ void VirtualMachine::process_LD(uint16_t instr)
 //  1   0   1   0 |     DR     |             PCoffset9
 // ------------------------------------------------------------------
 
-void VirtualMachine::process_LDI(uint16_t instr) // Load Indirect
+template <MemoryMode Mode>
+void VirtualMachine::process_LDI(uint16_t instr, LiveCounters &live) // Load Indirect
 {
   // 1010(decisionbits)  DR(3bit) PCoffset(9 bit)
 
@@ -337,7 +597,7 @@ void VirtualMachine::process_LDI(uint16_t instr) // Load Indirect
 
   // Program Counter'a(PC) eklenerek adrese ulaşılıyor.  PC + (Pcoffset 9)
 
-  reg[r0] = mem_read(mem_read(reg[to_underlying(Register::PC)] + pc_offset));
+  reg[r0] = mem_read<Mode>(mem_read<Mode>(reg[to_underlying(Register::PC)] + pc_offset, live), live);
   update_flags(r0);
 }
 
@@ -346,14 +606,15 @@ void VirtualMachine::process_LDI(uint16_t instr) // Load Indirect
 //  0   1   1   0 |     DR     |    BaseR   |       offset6
 // ------------------------------------------------------------------
 
-void VirtualMachine::process_LDR(uint16_t instr) // Load Register
+template <MemoryMode Mode>
+void VirtualMachine::process_LDR(uint16_t instr, LiveCounters &live) // Load Register
 {
   uint16_t r0 = (instr >> 9) & 0x7; // DR
   uint16_t r1 =
       (instr >> 6) & 0x7; // BaseR yani Register seçmek için bitlerimiz
   uint16_t offset = sign_extend(instr & 0x3F, 6);
 
-  reg[r0] = mem_read(reg[r1] + offset); // Destination Registera(DR) yazıyoruz.
+  reg[r0] = mem_read<Mode>(reg[r1] + offset, live); // Destination Registera(DR) yazıyoruz.
   update_flags(r0);
 }
 
@@ -376,10 +637,11 @@ void VirtualMachine::process_LEA(uint16_t instr) // Load Effective Address
 // ------------------------------------------------------------------
 //         BİT ADI SR OLARAK DEĞİŞTİ DİKKAT
 
-void VirtualMachine::process_ST(uint16_t instr) {
+template <MemoryMode Mode>
+void VirtualMachine::process_ST(uint16_t instr, LiveCounters &live) {
   uint16_t r0 = (instr >> 9) & 0x7;
   uint16_t pc_offset = sign_extend(instr & 0x1FF, 9);
-  mem_write(reg[to_underlying(Register::PC)] + pc_offset, reg[r0]);
+  mem_write<Mode>(reg[to_underlying(Register::PC)] + pc_offset, reg[r0], live);
 }
 
 // STI (Store Indirect) - Dolaylı Kaydetme (Çift Zıplama)
@@ -387,13 +649,14 @@ void VirtualMachine::process_ST(uint16_t instr) {
 //  1   0   1   1 |     SR     |             PCoffset9
 // ------------------------------------------------------------------
 
-void VirtualMachine::process_STI(uint16_t instr) 
+template <MemoryMode Mode>
+void VirtualMachine::process_STI(uint16_t instr, LiveCounters &live) 
 // Aynı LDI'daki gibi önce gidip bir adresin gösterdiği
                     // adresi okuyup oraya yazıyoruz. Pointer düşün.
 {
   uint16_t r0 = (instr >> 9) & 0x7;
   uint16_t pc_offset = sign_extend(instr & 0x1FF, 9);
-  mem_write(mem_read(reg[to_underlying(Register::PC)] + pc_offset), reg[r0]);
+  mem_write<Mode>(mem_read<Mode>(reg[to_underlying(Register::PC)] + pc_offset, live), reg[r0], live);
 }
 
 // STR (Store Base+Offset) - Tabana Göre Kaydetme
@@ -401,13 +664,14 @@ void VirtualMachine::process_STI(uint16_t instr)
 //  0   1   1   1 |     SR     |    BaseR   |       offset6
 // ------------------------------------------------------------------
 
-void VirtualMachine::process_STR(uint16_t instr)
+template <MemoryMode Mode>
+void VirtualMachine::process_STR(uint16_t instr, LiveCounters &live)
 // İstediğimiz bir alana erişip orada 6 bitlik offset sınırında (maksimum bu kadar ileri ya da geri gidebiliyoruz) depolama yapıyoruz.
 { 
   uint16_t r0 = (instr >> 9) & 0x7;
   uint16_t r1 = (instr >> 6) & 0x7;
   uint16_t offset = sign_extend(instr & 0x3F, 6);
-  mem_write(reg[r1] + offset, reg[r0]);
+  mem_write<Mode>(reg[r1] + offset, reg[r0], live);
 }
 
 // TRAP (System Call) - İşletim Sistemi Çağrısı
@@ -422,67 +686,210 @@ void VirtualMachine::process_TRAP(uint16_t instr) {
   reg[to_underlying(Register::R7)] = reg[to_underlying(Register::PC)];
   uint16_t trapvect = instr & 0xFF; // Hangi TRAP instruction onu çekiyoruz.
 
+  // GETC..HALT ardışık, kalanlar son slotta
+  const size_t slot = trapvect - to_underlying(Trap::GETC);
+  ++trap_counts[std::min(slot, TELEMETRY_TRAP_SLOTS - 1)];
+
   switch (static_cast<Trap>(trapvect)) {
   case Trap::GETC: {
-    reg[to_underlying(Register::R0)] = static_cast<uint16_t>(std::cin.get());  // get int döndürüyor bundan dolayı static_cast yapıyoruz.
+    if (!input_pending()) {
+      break;
+    }
+    const auto input_guard = lock_input();
+    const int key = wait_key();
+    if (!running) {
+      break; // SMP: beklerken başka çekirdek hatayla durdu
+    }
+    reg[to_underlying(Register::R0)] = static_cast<uint16_t>(key);  // get int döndürüyor bundan dolayı static_cast yapıyoruz.
     update_flags(to_underlying(Register::R0));
     break;
   }
 
   case Trap::OUT: {
-    std::cout.put(static_cast<char>(reg[to_underlying(Register::R0)]));
-    std::cout.flush();
+    const auto output_guard = lock_output();
+    emit(static_cast<char>(reg[to_underlying(Register::R0)]));
+    console->flush();
     break;
   }
 
   case Trap::PUTS: {
+    const auto output_guard = lock_output();
     uint16_t addr = reg[to_underlying(Register::R0)];
-    while (memory.at(addr) != 0x0000) {
-      std::cout.put(static_cast<char>(memory.at(addr)));
+    while (load(addr) != 0x0000) {
+      emit(static_cast<char>(load(addr)));
       addr++;
     }
-    std::cout.flush();
+    console->flush();
     break;
   }
 
   case Trap::IN: {
-    std::cout << "Karakter girin: " << std::flush;
-    char c = static_cast<char>(std::cin.get());
-    std::cout.put(c);
-    std::cout.flush();
+    if (!input_pending()) {
+      break;
+    }
+    // tuş gelene kadar sadece girdi kilidi tutuluyor, diğer çekirdekler yazmaya devam eder
+    const auto input_guard = lock_input();
+    {
+      const auto output_guard = lock_output();
+      for (char p : std::string_view("Karakter girin: ")) {
+        emit(p);
+      }
+      console->flush();
+    }
+    char c = static_cast<char>(wait_key());
+    if (!running) {
+      break;
+    }
+    {
+      const auto output_guard = lock_output();
+      emit(c);
+      console->flush();
+    }
     reg[to_underlying(Register::R0)] = static_cast<uint16_t>(c);
     update_flags(to_underlying(Register::R0));
     break;
   }
 
   case Trap::PUTSP: {
+    const auto output_guard = lock_output();
     uint16_t addr = reg[to_underlying(Register::R0)];
-    while (memory.at(addr) != 0x0000) {
-      uint16_t two_chars = memory.at(addr);
+    while (load(addr) != 0x0000) {
+      uint16_t two_chars = load(addr);
       char char1 = static_cast<char>(two_chars & 0xFF);
-      std::cout.put(char1);
+      emit(char1);
 
       char char2 = static_cast<char>(two_chars >> 8);
       if (char2 != 0) {
-        std::cout.put(char2);
+        emit(char2);
       }
       addr++;
     }
-    std::cout.flush();
+    console->flush();
     break;
   }
 
   case Trap::HALT: {
-    std::cout << "\nVM durduruluyor." << std::endl;
-    running = false;
+    // SMP'de mesajı son çıkan çekirdekten sonra SmpMachine yazıyor
+    if (bus == nullptr) {
+      announce_halt();
+    }
+    stop(StopReason::Halt);
     break;
   }
 
-  default:
-    std::cerr << "Bilinmeyen TRAP vektoru: 0x" << std::hex << trapvect
-              << std::dec << std::endl;
+  default: {
+    const auto output_guard = lock_output();
+    std::ostringstream message;
+    message << "Bilinmeyen TRAP vektoru: 0x" << std::hex << trapvect;
+    console->fault(message.str());
     break;
   }
+  }
+}
+
+void VirtualMachine::announce_halt() {
+  const auto output_guard = lock_output();
+  for (char c : std::string_view("\nVM durduruluyor.\n")) {
+    emit(c);
+  }
+  console->flush();
+}
+
+[[nodiscard]] std::unique_lock<std::mutex> VirtualMachine::lock_output() {
+  return bus != nullptr ? std::unique_lock(bus->console_lock) : std::unique_lock<std::mutex>();
+}
+
+[[nodiscard]] std::unique_lock<std::mutex> VirtualMachine::lock_input() {
+  return bus != nullptr ? std::unique_lock(bus->input_lock) : std::unique_lock<std::mutex>();
+}
+
+// GETC/IN öncesi: snapshot noktasındaysak ya da girdi bittiyse VM'i durdurur.
+[[nodiscard]] bool VirtualMachine::input_pending() {
+  if (input_barrier) {
+    stop(StopReason::InputBarrier);
+    return false;
+  }
+  if (console->at_end()) {
+    stop(StopReason::InputExhausted);
+    return false;
+  }
+  return true;
+}
+
+[[nodiscard]] int VirtualMachine::read_key() {
+  // SMP'de cin.get'te bloklanmıyoruz: tuşu zaman aşımlı bekleyip arada stopping'e bakıyoruz
+  if (bus != nullptr) {
+    while (!console->wait_ready(SMP_INPUT_POLL)) {
+      if (bus->stopping.load(std::memory_order_relaxed)) {
+        stop(StopReason::PeerFault);
+        return -1;
+      }
+    }
+  }
+  return console->get();
+}
+
+[[nodiscard]] int VirtualMachine::wait_key() {
+  if (telemetry == nullptr) {
+    return read_key();
+  }
+  end_poll_wait();
+  // kullanıcı tuşa basana kadar eski sayaçlar görünmesin
+  const int64_t began = telemetry_now_ns();
+  publish(VmState::WaitingInput);
+  telemetry->wait_started_ns.store(began, std::memory_order_relaxed);
+  const int c = read_key();
+  input_wait_ns += telemetry_now_ns() - began;
+  publish(VmState::Running);
+  return c;
+}
+
+void VirtualMachine::end_poll_wait() {
+  if (poll_wait_began_ns != 0) {
+    input_wait_ns += telemetry_now_ns() - poll_wait_began_ns;
+    wait_instructions += instruction_count - poll_wait_began_instructions;
+    poll_wait_began_ns = 0;
+  }
+}
+
+// Düz sayaçları telemetri alanına kopyalar. Sıcak döngüde değil, sadece senkron
+// noktalarında, girdi beklemeden önce ve dururken çağrılıyor.
+void VirtualMachine::publish(VmState state) {
+  const int64_t now = telemetry_now_ns();
+  // KBSR yoklaması sürüyorsa VM tuş bekliyor sayılıyor
+  if (state == VmState::Running && poll_wait_began_ns != 0) {
+    state = VmState::WaitingInput;
+    telemetry->wait_started_ns.store(poll_wait_began_ns, std::memory_order_relaxed);
+  }
+  if (state == VmState::Running && published_ns != 0 && now > published_ns) {
+    const double seconds = static_cast<double>(now - published_ns) / 1e9;
+    telemetry->current_mips.store(
+        static_cast<double>(instruction_count - published_instructions) / seconds / 1e6,
+        std::memory_order_relaxed);
+  }
+  published_ns = now;
+  published_instructions = instruction_count;
+
+  telemetry->pc.store(reg[to_underlying(Register::PC)], std::memory_order_relaxed);
+  telemetry->instructions.store(instruction_count, std::memory_order_relaxed);
+  telemetry->cycles.store(cycle_count, std::memory_order_relaxed);
+  telemetry->output_bytes.store(output_bytes, std::memory_order_relaxed);
+  telemetry->input_polls.store(input_polls, std::memory_order_relaxed);
+  // süren yoklamanın komutları da, instructions ile aynı anda görünsün diye
+  const uint64_t polling =
+      poll_wait_began_ns != 0 ? instruction_count - poll_wait_began_instructions : 0;
+  telemetry->wait_instructions.store(wait_instructions + polling, std::memory_order_relaxed);
+  telemetry->input_wait_ns.store(input_wait_ns, std::memory_order_relaxed);
+  for (size_t i = 0; i < TELEMETRY_TRAP_SLOTS; ++i) {
+    telemetry->traps[i].store(trap_counts[i], std::memory_order_relaxed);
+  }
+  telemetry->published_ns.store(now, std::memory_order_relaxed);
+  telemetry->state.store(state, std::memory_order_relaxed);
+}
+
+void VirtualMachine::stop(StopReason reason) {
+  stop_reason = reason;
+  running = false;
 }
 
 // ============================================================================
@@ -490,11 +897,20 @@ void VirtualMachine::process_TRAP(uint16_t instr) {
 // ============================================================================
 
 [[nodiscard]] int VirtualMachine::run(int argc, const char *argv[]) {
-  if (argc < 2) {
-    std::cerr << "Kullanim: lc3 [image-file1] ...\n";
+  if (!load_images(argc, argv)) {
     return 1;
   }
 
+  reset();
+  return execute();
+}
+
+[[nodiscard]] bool VirtualMachine::load_images(int argc, const char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Kullanim: lc3 [--cores N] [--clock MHZ | --turbo] [--telemetry SOKET] [image-file1] ...\n";
+    return false;
+  }
+
   bool any_loaded = false;
   for (int j = 1; j < argc; ++j) {
     if (read_image(argv[j])) {
@@ -506,68 +922,211 @@ void VirtualMachine::process_TRAP(uint16_t instr) {
 
   if (!any_loaded) {
     std::cerr << "Hata: Hicbir image dosyasi yuklenemedi.\n";
-    return 1;
+    return false;
   }
 
+  return true;
+}
+
+void VirtualMachine::reset() {
+  reg.fill(0);
   reg[to_underlying(Register::COND)] = to_underlying(ConditionFlag::ZRO);
   reg[to_underlying(Register::PC)] = PC_START;
+  running = true;
+  stop_reason = StopReason::None;
+  cycle_count = 0;
+  instruction_count = 0;
+  clock_high_latch = 0;
+  timer_interval = 0;
+  timer_deadline = 0;
+  output_bytes = 0;
+  input_polls = 0;
+  trap_counts.fill(0);
+  input_wait_ns = 0;
+  poll_wait_began_ns = 0;
+  wait_instructions = 0;
+  published_instructions = 0;
+  keyboard_status = 0;
+  keyboard_data = 0;
+}
+
+[[nodiscard]] int VirtualMachine::execute() {
+  next_timing_sync = timing.start(cycle_count);
+  if (telemetry != nullptr) {
+    telemetry->started_ns.store(telemetry_now_ns(), std::memory_order_relaxed);
+    published_ns = 0;
+    publish(VmState::Running);
+    next_publish = cycle_count + TELEMETRY_PUBLISH_CYCLES;
+  }
+  if (bus != nullptr) {
+    next_stop_check = cycle_count + SMP_STOP_CHECK_CYCLES;
+  }
+  next_sync = std::min({next_timing_sync, next_publish, next_stop_check, cycle_limit});
+
+  // sayaçlar döngüde yerel; üyelere sadece senkron noktasında ve yavaş yolda yazılıyor
+  LiveCounters live{.cycles = cycle_count, .instructions = instruction_count};
+  int result = 0;
+  switch (memory_mode) {
+  case MemoryMode::Flat:
+    result = run_loop<MemoryMode::Flat>(live);
+    break;
+  case MemoryMode::Paged:
+    result = run_loop<MemoryMode::Paged>(live);
+    break;
+  case MemoryMode::Shared:
+    result = run_loop<MemoryMode::Shared>(live);
+    break;
+  }
+  sync_counters(live);
+
+  if (telemetry != nullptr) {
+    end_poll_wait();
+    publish(VmState::Stopped);
+  }
+  timing.report(cycle_count, instruction_count);
+  return result;
+}
 
+template <MemoryMode Mode> [[nodiscard]] int VirtualMachine::run_loop(LiveCounters &live) {
   while (running) {
-    instr = mem_read(reg[to_underlying(Register::PC)]++);
-    op = instr >> 12;
+    if (!step<Mode>(live)) {
+      return 1;
+    }
 
-    switch (static_cast<Opcode>(op)) {
-    case Opcode::ADD:
-      process_ADD(instr);
-      break;
-    case Opcode::AND:
-      process_AND(instr);
-      break;
-    case Opcode::NOT:
-      process_NOT(instr);
-      break;
-    case Opcode::BR:
-      process_BR(instr);
-      break;
-    case Opcode::JMP:
-      process_JMP(instr);
-      break;
-    case Opcode::JSR:
-      process_JSR(instr);
-      break;
-    case Opcode::LD:
-      process_LD(instr);
-      break;
-    case Opcode::LDI:
-      process_LDI(instr);
-      break;
-    case Opcode::LDR:
-      process_LDR(instr);
-      break;
-    case Opcode::LEA:
-      process_LEA(instr);
-      break;
-    case Opcode::ST:
-      process_ST(instr);
-      break;
-    case Opcode::STI:
-      process_STI(instr);
-      break;
-    case Opcode::STR:
-      process_STR(instr);
-      break;
-    case Opcode::TRAP:
-      process_TRAP(instr);
+    // turbo modda, tek çekirdekte, limit ve telemetri yokken next_sync == NO_SYNC, yani bu karşılaştırma hiç tutmaz
+    if (live.cycles >= next_sync && !sync_point(live)) {
       break;
+    }
+  }
+  return 0;
+}
 
-    case Opcode::RES:
-    case Opcode::RTI:
-    default:
-      std::cerr << "Gecersiz opcode: 0x" << std::hex << op << std::dec << std::endl;
-      running = false;
-      return 1;
+[[nodiscard]] bool VirtualMachine::sync_point(LiveCounters &live) {
+  sync_counters(live);
+  if (cycle_count >= cycle_limit) {
+    stop(StopReason::CycleLimit);
+    return false;
+  }
+  if (cycle_count >= next_stop_check) {
+    if (bus->stopping.load(std::memory_order_relaxed)) {
+      stop(StopReason::PeerFault);
+      return false;
     }
+    next_stop_check = cycle_count + SMP_STOP_CHECK_CYCLES;
   }
+  if (cycle_count >= next_timing_sync) {
+    next_timing_sync = timing.sync(cycle_count);
+  }
+  if (telemetry != nullptr) {
+    publish(VmState::Running);
+    next_publish = cycle_count + TELEMETRY_PUBLISH_CYCLES;
+  }
+  next_sync = std::min({next_timing_sync, next_publish, next_stop_check, cycle_limit});
+  return true;
+}
 
-  return 0;
+[[nodiscard]] bool VirtualMachine::run_to_input(uint64_t max_cycles) {
+  input_barrier = true;
+  while (running && cycle_count < max_cycles) {
+    // giriş isteyen komut yarıda kalıyor, o yüzden her komuttan önceki durumu saklıyoruz
+    const auto saved_reg = reg;
+    const LiveCounters saved{.cycles = cycle_count, .instructions = instruction_count};
+    LiveCounters live = saved;
+
+    if (!step(live)) {
+      break;
+    }
+    if (stop_reason == StopReason::InputBarrier) {
+      reg = saved_reg;
+      sync_counters(saved);
+      running = true;
+      stop_reason = StopReason::None;
+      input_barrier = false;
+      return true;
+    }
+    sync_counters(live);
+  }
+  input_barrier = false;
+  return false;
+}
+
+// run_to_input gibi komut komut ilerleyen yollar için
+[[nodiscard]] bool VirtualMachine::step(LiveCounters &live) {
+  switch (memory_mode) {
+  case MemoryMode::Flat:
+    return step<MemoryMode::Flat>(live);
+  case MemoryMode::Shared:
+    return step<MemoryMode::Shared>(live);
+  case MemoryMode::Paged:
+    break;
+  }
+  return step<MemoryMode::Paged>(live);
+}
+
+// Tek komut: fetch, sanal saat, decode/execute. Geçersiz opcode'da false döner.
+template <MemoryMode Mode> [[nodiscard]] bool VirtualMachine::step(LiveCounters &live) {
+  instr = mem_read<Mode>(reg[to_underlying(Register::PC)]++, live);
+  op = instr >> 12;
+
+  live.cycles += OPCODE_CYCLES[op];
+  ++live.instructions;
+
+  switch (static_cast<Opcode>(op)) {
+  case Opcode::ADD:
+    process_ADD(instr);
+    break;
+  case Opcode::AND:
+    process_AND(instr);
+    break;
+  case Opcode::NOT:
+    process_NOT(instr);
+    break;
+  case Opcode::BR:
+    process_BR(instr);
+    break;
+  case Opcode::JMP:
+    process_JMP(instr);
+    break;
+  case Opcode::JSR:
+    process_JSR(instr);
+    break;
+  case Opcode::LD:
+    process_LD<Mode>(instr, live);
+    break;
+  case Opcode::LDI:
+    process_LDI<Mode>(instr, live);
+    break;
+  case Opcode::LDR:
+    process_LDR<Mode>(instr, live);
+    break;
+  case Opcode::LEA:
+    process_LEA(instr);
+    break;
+  case Opcode::ST:
+    process_ST<Mode>(instr, live);
+    break;
+  case Opcode::STI:
+    process_STI<Mode>(instr, live);
+    break;
+  case Opcode::STR:
+    process_STR<Mode>(instr, live);
+    break;
+  case Opcode::TRAP:
+    // TRAP'ler (telemetri, HALT) sayaçları üyelerden okuyor
+    sync_counters(live);
+    process_TRAP(instr);
+    break;
+
+  case Opcode::RES:
+  case Opcode::RTI:
+  default: {
+    std::ostringstream message;
+    message << "Gecersiz opcode: 0x" << std::hex << op;
+    console->fault(message.str());
+    stop(StopReason::InvalidOpcode);
+    return false;
+  }
+  }
+
+  return true;
 }